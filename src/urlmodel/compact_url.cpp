@@ -0,0 +1,453 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "compact_url.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "parser.hpp"
+
+using namespace urlmodel;
+
+namespace {
+enum header_field {
+	// size of the text and the components which are not present in the text, i.e. everything after the header
+	data_size,
+	text_size,
+	port,
+	num_path_segments,
+	num_query_params,
+
+	enum_size
+};
+
+// indices of the component strings, path segments go after the fixed ones
+// and query parameter names and values go after the path segments
+enum string_index {
+	scheme,
+	username,
+	password,
+	host,
+	fragment,
+
+	num_fixed_strings
+};
+
+// The header starts with a byte holding the size of the header fields, 2 or 4 bytes.
+// All the header field values are not greater than the URL text size, except the port which fits 16 bits anyway,
+// so URLs with text not longer than 64 KiB, i.e. virtually all URLs, have 16-bit header fields.
+constexpr size_t get_field_size_for_text(size_t text_size) noexcept
+{
+	return text_size <= std::numeric_limits<uint16_t>::max() ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+constexpr size_t get_header_size(size_t num_strings, size_t field_size) noexcept
+{
+	// each string is described by offset and size
+	return 1 + field_size * (header_field::enum_size + num_strings * 2);
+}
+
+// Calls visitor for each piece of URL text in the same order as url::to_string() outputs them.
+// Then calls visitor for the components which are not present in the URL text.
+// Visitor's piece(string_view) is called for delimiters, component(index, string_view) is called for components
+// and end_of_text() is called when URL text is over.
+template <typename visitor_type>
+void visit(const urlmodel::url& u, visitor_type& v)
+{
+	urlmodel::url::port_buffer port_buf{};
+
+	bool has_authority = !u.scheme.empty() && !u.host.empty();
+
+	if (!u.scheme.empty()) {
+		v.component(string_index::scheme, u.scheme);
+		if (has_authority) {
+			v.piece("://");
+			if (!u.username.empty()) {
+				v.component(string_index::username, u.username);
+
+				if (!u.password.empty()) {
+					v.piece(":");
+					v.component(string_index::password, u.password);
+				}
+
+				v.piece("@");
+			}
+
+			v.component(string_index::host, u.host);
+
+			if (u.port != 0) {
+				v.piece(":");
+				v.piece(urlmodel::url::render_port(u.port, port_buf));
+			}
+		} else {
+			v.piece(":");
+		}
+	} else {
+		// start with path
+		v.piece("/");
+	}
+
+	size_t index = string_index::num_fixed_strings;
+
+	for (const auto& p : u.path) {
+		v.piece("/");
+		v.component(index, p);
+		++index;
+	}
+
+	bool is_first = true;
+	for (const auto& q : u.query) {
+		if (is_first) {
+			is_first = false;
+			v.piece("?");
+		} else {
+			v.piece("&");
+		}
+
+		v.component(index, q.first);
+		++index;
+		v.piece("=");
+		v.component(index, q.second);
+		++index;
+	}
+
+	if (!u.fragment.empty()) {
+		v.piece("#");
+		v.component(string_index::fragment, u.fragment);
+	}
+
+	v.end_of_text();
+
+	// components which url::to_string() omits
+
+	if (!has_authority || u.username.empty()) {
+		v.component(string_index::username, u.username);
+	}
+	if (!has_authority || u.username.empty() || u.password.empty()) {
+		v.component(string_index::password, u.password);
+	}
+	if (!has_authority) {
+		v.component(string_index::host, u.host);
+	}
+	if (u.scheme.empty()) {
+		v.component(string_index::scheme, u.scheme);
+	}
+	if (u.fragment.empty()) {
+		v.component(string_index::fragment, u.fragment);
+	}
+}
+
+struct size_counter {
+	size_t size = 0;
+
+	void piece(std::string_view str) noexcept
+	{
+		this->size += str.size();
+	}
+
+	void component(size_t /* index */, std::string_view str) noexcept
+	{
+		this->size += str.size();
+	}
+
+	void end_of_text() noexcept {}
+};
+
+struct writer {
+	char* header;
+	char* text;
+	size_t field_size;
+	size_t pos = 0;
+
+	void set_field(size_t index, uint32_t value) noexcept
+	{
+		auto dst = std::next(this->header, ptrdiff_t(1 + index * this->field_size));
+		if (this->field_size == sizeof(uint16_t)) {
+			auto v = uint16_t(value);
+			std::memcpy(dst, &v, sizeof(v));
+		} else {
+			std::memcpy(dst, &value, sizeof(value));
+		}
+	}
+
+	void piece(std::string_view str) noexcept
+	{
+		std::memcpy(this->text + this->pos, str.data(), str.size());
+		this->pos += str.size();
+	}
+
+	void component(size_t index, std::string_view str) noexcept
+	{
+		auto field_index = header_field::enum_size + index * 2;
+		this->set_field(field_index, uint32_t(this->pos));
+		this->set_field(field_index + 1, uint32_t(str.size()));
+		this->piece(str);
+	}
+
+	void end_of_text() noexcept
+	{
+		this->set_field(header_field::text_size, uint32_t(this->pos));
+	}
+};
+} // namespace
+
+compact_url::compact_url() :
+	compact_url(urlmodel::url())
+{}
+
+compact_url::compact_url(const urlmodel::url& url)
+{
+	size_counter counter;
+	visit(url, counter);
+
+	if (counter.size > std::numeric_limits<uint32_t>::max()) {
+		throw std::invalid_argument("urlmodel: compact_url: URL is too big");
+	}
+
+	size_t num_strings = string_index::num_fixed_strings + url.path.size() + url.query.size() * 2;
+	auto field_size = get_field_size_for_text(counter.size);
+	auto header_size = get_header_size(num_strings, field_size);
+
+	this->buf = std::make_unique<char[]>(header_size + counter.size);
+	this->buf[0] = char(field_size);
+
+	writer w{this->buf.get(), std::next(this->buf.get(), ptrdiff_t(header_size)), field_size};
+
+	w.set_field(header_field::data_size, uint32_t(counter.size));
+	w.set_field(header_field::port, url.port);
+	w.set_field(header_field::num_path_segments, uint32_t(url.path.size()));
+	w.set_field(header_field::num_query_params, uint32_t(url.query.size()));
+
+	visit(url, w);
+
+	ASSERT(w.pos == counter.size)
+}
+
+compact_url::compact_url(const compact_url& u)
+{
+	*this = u;
+}
+
+compact_url& compact_url::operator=(const compact_url& u)
+{
+	if (this == &u) {
+		return *this;
+	}
+
+	if (!u.buf) {
+		this->buf.reset();
+		return *this;
+	}
+
+	auto size = u.buffer_size();
+	this->buf = std::make_unique<char[]>(size);
+	std::memcpy(this->buf.get(), u.buf.get(), size);
+
+	return *this;
+}
+
+size_t compact_url::buffer_size() const noexcept
+{
+	if (!this->buf) {
+		return 0;
+	}
+
+	size_t num_strings = string_index::num_fixed_strings + this->num_path_segments() + this->num_query_params() * 2;
+
+	return get_header_size(num_strings, this->get_field_size()) + this->get_header_field(header_field::data_size);
+}
+
+bool compact_url::operator==(const compact_url& u) const noexcept
+{
+	auto size = this->buffer_size();
+	if (size != u.buffer_size()) {
+		return false;
+	}
+	return size == 0 || std::memcmp(this->buf.get(), u.buf.get(), size) == 0;
+}
+
+compact_url compact_url::parse(utki::span<const uint8_t> data)
+{
+	urlmodel::parser parser;
+	parser.feed(data);
+	parser.end_of_data();
+
+	return compact_url(parser.url);
+}
+
+size_t compact_url::get_field_size() const noexcept
+{
+	ASSERT(this->buf)
+	return size_t(this->buf[0]);
+}
+
+uint32_t compact_url::get_header_field(size_t index) const noexcept
+{
+	auto field_size = this->get_field_size();
+
+	auto src = std::next(this->buf.get(), ptrdiff_t(1 + index * field_size));
+	if (field_size == sizeof(uint16_t)) {
+		uint16_t ret = 0;
+		std::memcpy(&ret, src, sizeof(ret));
+		return ret;
+	}
+
+	uint32_t ret = 0;
+	std::memcpy(&ret, src, sizeof(ret));
+	return ret;
+}
+
+std::string_view compact_url::get_string(size_t index) const noexcept
+{
+	size_t num_strings = string_index::num_fixed_strings + this->num_path_segments() + this->num_query_params() * 2;
+	ASSERT(index < num_strings)
+
+	auto field_index = header_field::enum_size + index * 2;
+	auto offset = this->get_header_field(field_index);
+	auto size = this->get_header_field(field_index + 1);
+
+	auto text = std::next(this->buf.get(), ptrdiff_t(get_header_size(num_strings, this->get_field_size())));
+
+	return std::string_view(std::next(text, offset), size);
+}
+
+std::string_view compact_url::scheme() const noexcept
+{
+	return this->get_string(string_index::scheme);
+}
+
+std::string_view compact_url::username() const noexcept
+{
+	return this->get_string(string_index::username);
+}
+
+std::string_view compact_url::password() const noexcept
+{
+	return this->get_string(string_index::password);
+}
+
+std::string_view compact_url::host() const noexcept
+{
+	return this->get_string(string_index::host);
+}
+
+uint16_t compact_url::port() const noexcept
+{
+	return uint16_t(this->get_header_field(header_field::port));
+}
+
+size_t compact_url::num_path_segments() const noexcept
+{
+	return this->get_header_field(header_field::num_path_segments);
+}
+
+std::string_view compact_url::path_segment(size_t index) const noexcept
+{
+	ASSERT(index < this->num_path_segments())
+	return this->get_string(string_index::num_fixed_strings + index);
+}
+
+size_t compact_url::num_query_params() const noexcept
+{
+	return this->get_header_field(header_field::num_query_params);
+}
+
+std::pair<std::string_view, std::string_view> compact_url::query_param(size_t index) const noexcept
+{
+	ASSERT(index < this->num_query_params())
+	auto string_index = string_index::num_fixed_strings + this->num_path_segments() + index * 2;
+	return {this->get_string(string_index), this->get_string(string_index + 1)};
+}
+
+std::optional<std::string_view> compact_url::query_value(std::string_view name) const noexcept
+{
+	// query parameters are sorted by name, so use binary search
+	size_t begin = 0;
+	size_t end = this->num_query_params();
+
+	while (begin != end) {
+		auto middle = begin + (end - begin) / 2;
+		auto param = this->query_param(middle);
+
+		auto res = param.first.compare(name);
+		if (res == 0) {
+			return param.second;
+		} else if (res < 0) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+
+	return std::nullopt;
+}
+
+std::string_view compact_url::fragment() const noexcept
+{
+	return this->get_string(string_index::fragment);
+}
+
+std::string_view compact_url::to_string_view() const noexcept
+{
+	size_t num_strings = string_index::num_fixed_strings + this->num_path_segments() + this->num_query_params() * 2;
+
+	return std::string_view(
+		std::next(this->buf.get(), ptrdiff_t(get_header_size(num_strings, this->get_field_size()))),
+		this->get_header_field(header_field::text_size)
+	);
+}
+
+urlmodel::url compact_url::to_url() const
+{
+	urlmodel::url ret;
+
+	ret.scheme = this->scheme();
+	ret.username = this->username();
+	ret.password = this->password();
+	ret.host = this->host();
+	ret.port = this->port();
+
+	auto num_segments = this->num_path_segments();
+	ret.path.reserve(num_segments);
+	for (size_t i = 0; i != num_segments; ++i) {
+		ret.path.emplace_back(this->path_segment(i));
+	}
+
+	auto num_params = this->num_query_params();
+	for (size_t i = 0; i != num_params; ++i) {
+		auto param = this->query_param(i);
+
+		// parameters are already sorted, so insert to the end
+		ret.query.emplace_hint(ret.query.end(), param.first, param.second);
+	}
+
+	ret.fragment = this->fragment();
+
+	return ret;
+}
@@ -0,0 +1,160 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <utki/span.hpp>
+
+#include "url.hpp"
+
+namespace urlmodel {
+
+/**
+ * @brief Compact URL representation.
+ * Holds the whole URL in a single contiguous memory buffer: a small header with offsets and sizes of
+ * all the URL components, followed by the URL text as it is returned by url::to_string().
+ * The header fields are 16-bit for URL text up to 64 KiB long, and 32-bit for longer URLs.
+ * The buffer size is stored in the header, so the object itself is a single pointer.
+ * The components are string views into that text, so the URL takes a single memory allocation and
+ * copying the URL is a single memory copy.
+ * The compact URL is immutable, to modify it, convert it to url, modify and convert back.
+ */
+class compact_url
+{
+	// header, text and components which are not present in the text, e.g. host of the URL without scheme
+	std::unique_ptr<char[]> buf;
+
+	size_t get_field_size() const noexcept;
+	uint32_t get_header_field(size_t index) const noexcept;
+	std::string_view get_string(size_t index) const noexcept;
+
+public:
+	/**
+   * @brief Construct empty URL.
+   */
+	compact_url();
+
+	/**
+   * @brief Construct from url.
+   * @param url - URL to convert.
+   * @throw std::invalid_argument in case URL is too big, i.e. longer than 4 GiB.
+   */
+	explicit compact_url(const urlmodel::url& url);
+
+	compact_url(const compact_url& u);
+	compact_url& operator=(const compact_url& u);
+
+	/**
+   * @brief Move constructor.
+   * The moved-from URL can only be destroyed or assigned to.
+   */
+	compact_url(compact_url&&) noexcept = default;
+
+	/**
+   * @brief Move assignment.
+   * The moved-from URL can only be destroyed or assigned to.
+   */
+	compact_url& operator=(compact_url&&) noexcept = default;
+
+	~compact_url() = default;
+
+	/**
+   * @brief Parse URL to compact representation.
+   * Same as feeding the data to the urlmodel::parser followed by end of data and
+   * converting the parsed url to compact_url.
+   * @param data - URL to parse.
+   * @return parsed URL.
+   * @throw std::invalid_argument in case of malformed URL.
+   */
+	static compact_url parse(utki::span<const uint8_t> data);
+
+	/**
+   * @brief Convert to url.
+   * @return url object with the same components.
+   */
+	urlmodel::url to_url() const;
+
+	std::string_view scheme() const noexcept;
+	std::string_view username() const noexcept;
+	std::string_view password() const noexcept;
+	std::string_view host() const noexcept;
+	uint16_t port() const noexcept;
+
+	size_t num_path_segments() const noexcept;
+	std::string_view path_segment(size_t index) const noexcept;
+
+	/**
+   * @brief Get number of query parameters.
+   * @return number of query parameters.
+   */
+	size_t num_query_params() const noexcept;
+
+	/**
+   * @brief Get query parameter.
+   * Query parameters are sorted by name, same as in url::query.
+   * @param index - index of the query parameter.
+   * @return pair of name and value of the query parameter.
+   */
+	std::pair<std::string_view, std::string_view> query_param(size_t index) const noexcept;
+
+	/**
+   * @brief Find query parameter value by name.
+   * @param name - name of the query parameter.
+   * @return value of the query parameter.
+   * @return std::nullopt in case there is no query parameter with the given name.
+   */
+	std::optional<std::string_view> query_value(std::string_view name) const noexcept;
+
+	std::string_view fragment() const noexcept;
+
+	/**
+   * @brief Get URL text.
+   * @return string view of the same URL text as url::to_string() returns.
+   */
+	std::string_view to_string_view() const noexcept;
+
+	std::string to_string() const
+	{
+		return std::string(this->to_string_view());
+	}
+
+	/**
+   * @brief Get size of the memory buffer.
+   * @return number of bytes occupied by the URL in the heap.
+   */
+	size_t buffer_size() const noexcept;
+
+	bool operator==(const compact_url& u) const noexcept;
+};
+
+} // namespace urlmodel
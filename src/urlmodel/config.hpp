@@ -0,0 +1,42 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+// Header-only mode.
+// In case URLMODEL_HEADER_ONLY macro is defined before including urlmodel/parser.hpp or urlmodel/url.hpp,
+// the implementation of urlmodel::url is included right into the header as inline functions and
+// the default urlmodel::parser is instantiated in the calling code instead of being taken from the library,
+// so there is no need to link to liburlmodel for these classes and the compiler is able to inline
+// and specialize the parser in the calling code.
+// The macro has to be defined consistently for all translation units of the program,
+// e.g. via compiler command line.
+
+#ifdef URLMODEL_HEADER_ONLY
+#	define URLMODEL_INLINE inline
+#else
+#	define URLMODEL_INLINE
+#endif
@@ -0,0 +1,249 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "host_matcher.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace urlmodel;
+
+namespace {
+// domain name label cannot be longer than 63 characters, see RFC 1035
+constexpr size_t max_label_size = 63;
+
+char to_lower(char c) noexcept
+{
+	if (c >= 'A' && c <= 'Z') {
+		return char(c - 'A' + 'a');
+	}
+	return c;
+}
+
+// compares lower-case label from the labels pool to a label of the host name being matched
+int compare_label(std::string_view pooled, std::string_view label) noexcept
+{
+	auto size = std::min(pooled.size(), label.size());
+	for (size_t i = 0; i != size; ++i) {
+		auto a = uint8_t(pooled[i]);
+		auto b = uint8_t(to_lower(label[i]));
+		if (a != b) {
+			return a < b ? -1 : 1;
+		}
+	}
+
+	if (pooled.size() == label.size()) {
+		return 0;
+	}
+	return pooled.size() < label.size() ? -1 : 1;
+}
+
+struct build_node {
+	std::map<std::string, uint32_t> children;
+	uint8_t flags = 0;
+	host_matcher::payload_type exact_payload = 0;
+	host_matcher::payload_type wildcard_payload = 0;
+};
+} // namespace
+
+host_matcher::host_matcher(utki::span<const rule> rules)
+{
+	std::vector<build_node> tree(1);
+
+	for (const auto& r : rules) {
+		auto domain = r.domain;
+
+		if (!domain.empty() && domain.back() == '.') {
+			domain.remove_suffix(1);
+		}
+
+		bool is_wildcard = false;
+		if (domain == "*") {
+			is_wildcard = true;
+			domain = std::string_view();
+		} else if (domain.size() >= 2 && domain.substr(0, 2) == "*.") {
+			is_wildcard = true;
+			domain = domain.substr(2);
+		}
+
+		if (domain.empty() && !is_wildcard) {
+			throw std::invalid_argument("urlmodel: host_matcher: empty domain rule");
+		}
+
+		uint32_t cur = 0;
+		while (!domain.empty()) {
+			auto dot_pos = domain.rfind('.');
+			auto label = dot_pos == std::string_view::npos ? domain : domain.substr(dot_pos + 1);
+
+			if (label.empty() || label.size() > max_label_size || label.find('*') != std::string_view::npos) {
+				std::stringstream ss;
+				ss << "urlmodel: host_matcher: malformed domain rule: " << r.domain;
+				throw std::invalid_argument(ss.str());
+			}
+
+			std::string lower_label;
+			lower_label.reserve(label.size());
+			std::transform(label.begin(), label.end(), std::back_inserter(lower_label), &to_lower);
+
+			auto i = tree[cur].children.find(lower_label);
+			if (i == tree[cur].children.end()) {
+				auto index = uint32_t(tree.size());
+				tree[cur].children.emplace(std::move(lower_label), index);
+				tree.emplace_back();
+				cur = index;
+			} else {
+				cur = i->second;
+			}
+
+			if (dot_pos == std::string_view::npos) {
+				break;
+			}
+			domain = domain.substr(0, dot_pos);
+		}
+
+		auto& n = tree[cur];
+		if (is_wildcard) {
+			n.flags |= flag::wildcard;
+			n.wildcard_payload = r.payload;
+		} else {
+			n.flags |= flag::exact;
+			n.exact_payload = r.payload;
+		}
+	}
+
+	if (tree.size() > std::numeric_limits<uint32_t>::max()) {
+		throw std::invalid_argument("urlmodel: host_matcher: too many domain rules");
+	}
+
+	// flatten the tree in breadth-first order, so that children of each node are contiguous
+
+	// order[i] is index into the tree of the node stored at this->nodes[i]
+	std::vector<uint32_t> order;
+	order.reserve(tree.size());
+	order.push_back(0);
+
+	this->nodes.reserve(tree.size());
+	this->nodes.push_back(node{});
+
+	std::unordered_map<std::string_view, uint32_t> label_offsets;
+
+	for (size_t i = 0; i != order.size(); ++i) {
+		const auto& bn = tree[order[i]];
+
+		auto& n = this->nodes[i];
+		n.flags = bn.flags;
+		n.exact_payload = bn.exact_payload;
+		n.wildcard_payload = bn.wildcard_payload;
+		n.children_begin = uint32_t(this->nodes.size());
+		n.num_children = uint32_t(bn.children.size());
+
+		// children are iterated in ascending label order, so children range ends up sorted
+		for (const auto& c : bn.children) {
+			auto offset_i = label_offsets.find(c.first);
+			if (offset_i == label_offsets.end()) {
+				auto offset = uint32_t(this->labels.size());
+				this->labels.append(c.first);
+				offset_i = label_offsets.emplace(c.first, offset).first;
+			}
+
+			node child{};
+			child.label_offset = offset_i->second;
+			child.label_size = uint8_t(c.first.size());
+
+			// NOTE: this may reallocate nodes, so the 'n' reference must not be used after this
+			this->nodes.push_back(child);
+			order.push_back(c.second);
+		}
+	}
+
+	this->labels.shrink_to_fit();
+}
+
+const host_matcher::node* host_matcher::find_child(const node& parent, std::string_view label) const noexcept
+{
+	auto begin = std::next(this->nodes.begin(), parent.children_begin);
+	auto end = std::next(begin, parent.num_children);
+
+	auto i = std::lower_bound(begin, end, label, [this](const node& n, std::string_view l) {
+		return compare_label(std::string_view(this->labels).substr(n.label_offset, n.label_size), l) < 0;
+	});
+
+	if (i == end) {
+		return nullptr;
+	}
+
+	if (compare_label(std::string_view(this->labels).substr(i->label_offset, i->label_size), label) != 0) {
+		return nullptr;
+	}
+
+	return &*i;
+}
+
+std::optional<host_matcher::payload_type> host_matcher::match(std::string_view host) const noexcept
+{
+	if (!host.empty() && host.back() == '.') {
+		host.remove_suffix(1);
+	}
+
+	if (host.empty() || this->nodes.empty()) {
+		return std::nullopt;
+	}
+
+	std::optional<payload_type> ret;
+
+	const node* n = &this->nodes.front();
+	for (;;) {
+		// there is at least one more label left in the host name,
+		// so wildcard rule of the current node matches
+		if (n->flags & flag::wildcard) {
+			ret = n->wildcard_payload;
+		}
+
+		auto dot_pos = host.rfind('.');
+		auto label = dot_pos == std::string_view::npos ? host : host.substr(dot_pos + 1);
+
+		n = this->find_child(*n, label);
+		if (!n) {
+			return ret;
+		}
+
+		if (dot_pos == std::string_view::npos) {
+			break;
+		}
+		host = host.substr(0, dot_pos);
+	}
+
+	if (n->flags & flag::exact) {
+		return n->exact_payload;
+	}
+
+	return ret;
+}
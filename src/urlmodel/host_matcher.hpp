@@ -0,0 +1,119 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <utki/span.hpp>
+
+namespace urlmodel {
+
+/**
+ * @brief Host name matcher.
+ * Matches host names against a list of domain rules.
+ * A rule is either an exact domain name, e.g. "example.com", which matches only that host name,
+ * or a wildcard domain name, e.g. "*.example.com", which matches any subdomain of example.com,
+ * but not the example.com itself. A single "*" rule matches any non-empty host name.
+ * The rules are compiled into a trie of reversed domain name labels, so a host name is matched
+ * in a single right-to-left pass without memory allocations.
+ * Domain names are matched case-insensitively, one trailing dot is ignored.
+ */
+class host_matcher
+{
+public:
+	/**
+   * @brief Payload attached to a rule.
+   * Typically, it is an index into user's own array of rule data.
+   */
+	using payload_type = uint32_t;
+
+	struct rule {
+		std::string_view domain;
+		payload_type payload;
+	};
+
+private:
+	enum flag : uint8_t {
+		exact = 1 << 0,
+		wildcard = 1 << 1
+	};
+
+	// children of a node are stored contiguously in the nodes array, sorted by label
+	struct node {
+		uint32_t label_offset;
+		uint8_t label_size;
+		uint8_t flags;
+		uint32_t children_begin;
+		uint32_t num_children;
+		payload_type exact_payload;
+		payload_type wildcard_payload;
+	};
+
+	// nodes[0] is the root node, it has no label
+	std::vector<node> nodes;
+
+	// pool of all node labels, each distinct label is stored only once
+	std::string labels;
+
+	const node* find_child(const node& parent, std::string_view label) const noexcept;
+
+public:
+	host_matcher() = default;
+
+	/**
+   * @brief Compile rules.
+   * In case the same domain rule is listed more than once, the last one wins.
+   * @param rules - list of domain rules.
+   * @throw std::invalid_argument in case of malformed domain rule.
+   */
+	host_matcher(utki::span<const rule> rules);
+
+	/**
+   * @brief Match host name against the rules.
+   * In case several rules match the host name, the most specific one wins, i.e.
+   * exact match wins over a wildcard and longer wildcard domain wins over a shorter one.
+   * @param host - host name to match.
+   * @return payload of the matched rule.
+   * @return std::nullopt if no rule matches the host name.
+   */
+	std::optional<payload_type> match(std::string_view host) const noexcept;
+
+	/**
+   * @brief Get number of nodes in the compiled trie.
+   * @return number of trie nodes, including the root node.
+   */
+	size_t num_nodes() const noexcept
+	{
+		return this->nodes.size();
+	}
+};
+
+} // namespace urlmodel
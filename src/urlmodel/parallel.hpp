@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace urlmodel::detail {
+
+// returns number of hardware threads in case num_threads is 0
+inline unsigned get_num_threads(unsigned num_threads) noexcept
+{
+	if (num_threads == 0) {
+		num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	return num_threads;
+}
+
+// joins the threads on destruction, including stack unwinding, as destroying a joinable thread terminates the program
+struct thread_joiner {
+	std::vector<std::thread> threads;
+
+	thread_joiner() = default;
+
+	thread_joiner(const thread_joiner&) = delete;
+	thread_joiner& operator=(const thread_joiner&) = delete;
+
+	thread_joiner(thread_joiner&&) = delete;
+	thread_joiner& operator=(thread_joiner&&) = delete;
+
+	~thread_joiner()
+	{
+		for (auto& t : this->threads) {
+			t.join();
+		}
+	}
+};
+
+// Splits [0, size) range into num_chunks consecutive chunks of equal size and calls func(chunk, begin, end)
+// for each non-empty chunk in parallel, one thread per chunk. The first chunk is processed in the calling thread.
+// In case the first chunk is the only one, func(0, 0, 0) is called for empty range as well.
+template <typename func_type>
+void parallel_for_chunks(size_t size, size_t num_chunks, func_type func)
+{
+	auto chunk_size = (size + num_chunks - 1) / std::max(num_chunks, size_t(1));
+
+	// in case func throws in the calling thread, the started threads are joined before the exception propagates
+	thread_joiner joiner;
+	auto& threads = joiner.threads;
+
+	size_t chunk = 1;
+	try {
+		for (; chunk < num_chunks && chunk * chunk_size < size; ++chunk) {
+			auto begin = chunk * chunk_size;
+			threads.emplace_back(func, chunk, begin, std::min(begin + chunk_size, size));
+		}
+	} catch (std::system_error&) {
+		// could not start more threads, process the rest of chunks in this thread
+		for (; chunk < num_chunks && chunk * chunk_size < size; ++chunk) {
+			auto begin = chunk * chunk_size;
+			func(chunk, begin, std::min(begin + chunk_size, size));
+		}
+	}
+
+	func(size_t(0), size_t(0), std::min(chunk_size, size));
+}
+
+} // namespace urlmodel::detail
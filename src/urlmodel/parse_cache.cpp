@@ -0,0 +1,181 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "parse_cache.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#include <utki/string.hpp>
+
+#include "parser.hpp"
+
+using namespace urlmodel;
+
+parse_cache::parse_cache(size_t capacity, size_t num_shards, size_t max_key_size) :
+	max_key_size(max_key_size),
+	num_shards(std::min(num_shards, capacity))
+{
+	if (capacity == 0) {
+		throw std::invalid_argument("urlmodel: parse_cache: capacity must be greater than zero");
+	}
+
+	if (num_shards == 0) {
+		throw std::invalid_argument("urlmodel: parse_cache: number of shards must be greater than zero");
+	}
+
+	this->shards = std::make_unique<shard[]>(this->num_shards);
+
+	// split the capacity evenly, the remainder goes to the first shards
+	for (size_t i = 0; i != this->num_shards; ++i) {
+		this->shards[i].capacity = capacity / this->num_shards + (i < capacity % this->num_shards ? 1 : 0);
+	}
+}
+
+std::shared_ptr<const urlmodel::url> parse_cache::parse_cached(utki::span<const uint8_t> data)
+{
+	auto key = utki::make_string_view(data);
+
+	auto hash = std::hash<std::string_view>()(key);
+
+	auto& s = this->shards[hash % this->num_shards];
+
+	{
+		std::lock_guard lock(s.mutex);
+
+		auto i = s.index.find(hash);
+		if (i != s.index.end()) {
+			auto& e = s.entries[i->second];
+			if (e.key == key) {
+				e.referenced = true;
+				++s.stats.hits;
+				return e.url;
+			}
+		}
+
+		++s.stats.misses;
+	}
+
+	// parse without holding the lock, so that other threads can use the shard meanwhile
+
+	urlmodel::parser parser;
+	if (!parser.feed(data).empty()) {
+		// URL ended before the end of data, e.g. at a space
+		throw std::invalid_argument("urlmodel: parse_cache: data contains more than one URL");
+	}
+	parser.end_of_data();
+
+	auto ret = std::make_shared<const urlmodel::url>(std::move(parser.url));
+
+	if (data.size() > this->max_key_size) {
+		return ret;
+	}
+
+	{
+		std::lock_guard lock(s.mutex);
+
+		// the same URL could be inserted by another thread while we were parsing
+		auto i = s.index.find(hash);
+		if (i != s.index.end()) {
+			auto& e = s.entries[i->second];
+			if (e.key == key) {
+				return e.url;
+			}
+		}
+
+		insert(s, entry{hash, std::string(key), ret, false});
+	}
+
+	return ret;
+}
+
+void parse_cache::insert(shard& s, entry e)
+{
+	size_t pos = 0;
+
+	if (s.entries.size() < s.capacity) {
+		pos = s.entries.size();
+		s.entries.push_back(std::move(e));
+	} else {
+		// find victim using CLOCK algorithm
+		for (;; s.clock_hand = (s.clock_hand + 1) % s.entries.size()) {
+			auto& victim = s.entries[s.clock_hand];
+			if (victim.referenced) {
+				victim.referenced = false;
+				continue;
+			}
+			break;
+		}
+
+		pos = s.clock_hand;
+		s.clock_hand = (s.clock_hand + 1) % s.entries.size();
+
+		auto& victim = s.entries[pos];
+
+		// index could have been overwritten by another key with the same hash
+		auto i = s.index.find(victim.hash);
+		if (i != s.index.end() && i->second == pos) {
+			s.index.erase(i);
+		}
+
+		victim = std::move(e);
+		++s.stats.evictions;
+	}
+
+	// in case of hash collision the newer entry wins
+	s.index.insert_or_assign(s.entries[pos].hash, pos);
+}
+
+parse_cache::statistics parse_cache::get_statistics() const
+{
+	statistics ret;
+
+	for (size_t i = 0; i != this->num_shards; ++i) {
+		auto& s = this->shards[i];
+
+		std::lock_guard lock(s.mutex);
+
+		ret.hits += s.stats.hits;
+		ret.misses += s.stats.misses;
+		ret.evictions += s.stats.evictions;
+	}
+
+	return ret;
+}
+
+void parse_cache::clear()
+{
+	for (size_t i = 0; i != this->num_shards; ++i) {
+		auto& s = this->shards[i];
+
+		std::lock_guard lock(s.mutex);
+
+		s.entries.clear();
+		s.index.clear();
+		s.clock_hand = 0;
+	}
+}
@@ -0,0 +1,136 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <utki/span.hpp>
+
+#include "url.hpp"
+
+namespace urlmodel {
+
+/**
+ * @brief Thread-safe cache of parsed URLs.
+ * Maps raw URL bytes to immutable parsed URL objects.
+ * The cache is split into shards, each shard is protected by its own mutex,
+ * so that threads looking up different URLs mostly do not contend on the same lock.
+ * Each shard holds a fixed number of entries and evicts them using the CLOCK algorithm.
+ */
+class parse_cache
+{
+public:
+	struct statistics {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+	};
+
+private:
+	struct entry {
+		size_t hash;
+		std::string key;
+		std::shared_ptr<const urlmodel::url> url;
+
+		// CLOCK algorithm reference bit
+		bool referenced;
+	};
+
+	// align to cache line size to avoid false sharing between shards
+	struct alignas(64) shard {
+		std::mutex mutex;
+
+		std::vector<entry> entries;
+
+		// maps key hash to index into entries
+		std::unordered_map<size_t, size_t> index;
+
+		size_t clock_hand = 0;
+
+		// maximum number of entries in the shard
+		size_t capacity = 0;
+
+		statistics stats;
+	};
+
+	size_t max_key_size;
+
+	std::unique_ptr<shard[]> shards;
+	size_t num_shards;
+
+	static void insert(shard& s, entry e);
+
+public:
+	/**
+   * @brief Constructor.
+   * @param capacity - maximum number of cached URLs.
+   * @param num_shards - number of shards, must be greater than zero. The capacity is split among the shards,
+   *     so the number of shards is limited to the capacity.
+   * @param max_key_size - URLs longer than this number of bytes are parsed, but not cached.
+   * @throw std::invalid_argument in case capacity or number of shards is zero.
+   */
+	parse_cache(size_t capacity, size_t num_shards = 16, size_t max_key_size = 2048);
+
+	parse_cache(const parse_cache&) = delete;
+	parse_cache& operator=(const parse_cache&) = delete;
+
+	parse_cache(parse_cache&&) = delete;
+	parse_cache& operator=(parse_cache&&) = delete;
+
+	~parse_cache() = default;
+
+	/**
+   * @brief Parse URL using the cache.
+   * In case the exactly same URL bytes were parsed before and are still in the cache, the cached
+   * result is returned. Otherwise, the URL is parsed and the result is put to the cache.
+   * The whole data is treated as URL, as if it was fed to the parser followed by end of data.
+   * @param data - URL to parse.
+   * @return parsed URL.
+   * @throw std::invalid_argument in case of malformed URL or in case the URL ends before the end of data,
+   *     e.g. at a space. Malformed URLs are not cached.
+   */
+	std::shared_ptr<const urlmodel::url> parse_cached(utki::span<const uint8_t> data);
+
+	/**
+   * @brief Get cache statistics.
+   * @return sum of statistics of all shards.
+   */
+	statistics get_statistics() const;
+
+	/**
+   * @brief Remove all entries from the cache.
+   * Statistics are not reset.
+   */
+	void clear();
+};
+
+} // namespace urlmodel
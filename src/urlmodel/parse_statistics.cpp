@@ -0,0 +1,93 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "parse_statistics.hpp"
+
+using namespace urlmodel;
+
+namespace {
+constexpr std::array<const char*, parse_statistics::num_states> state_names = {
+	"scheme",
+	"authority_prefix",
+	"authority",
+	"path",
+	"query_name",
+	"query_value",
+	"fragment"
+};
+} // namespace
+
+void parse_statistics::add_latency(uint64_t nanoseconds) noexcept
+{
+	size_t bucket = 0;
+	for (; nanoseconds > 1; nanoseconds >>= 1) {
+		++bucket;
+	}
+
+	++this->latency_histogram[bucket];
+}
+
+parse_statistics& parse_statistics::operator+=(const parse_statistics& s) noexcept
+{
+	for (size_t i = 0; i != num_states; ++i) {
+		this->bytes_per_state[i] += s.bytes_per_state[i];
+		this->errors_per_state[i] += s.errors_per_state[i];
+	}
+
+	this->num_feed_calls += s.num_feed_calls;
+	this->num_urls += s.num_urls;
+	this->num_buf_reallocations += s.num_buf_reallocations;
+	this->num_url_heap_buffers += s.num_url_heap_buffers;
+
+	for (size_t i = 0; i != num_latency_buckets; ++i) {
+		this->latency_histogram[i] += s.latency_histogram[i];
+	}
+
+	return *this;
+}
+
+void parse_statistics::write(std::ostream& o) const
+{
+	o << "feed_calls " << this->num_feed_calls << '\n';
+	o << "urls " << this->num_urls << '\n';
+	o << "buf_reallocations " << this->num_buf_reallocations << '\n';
+	o << "url_heap_buffers " << this->num_url_heap_buffers << '\n';
+
+	for (size_t i = 0; i != num_states; ++i) {
+		o << "bytes." << state_names[i] << ' ' << this->bytes_per_state[i] << '\n';
+	}
+
+	for (size_t i = 0; i != num_states; ++i) {
+		o << "errors." << state_names[i] << ' ' << this->errors_per_state[i] << '\n';
+	}
+
+	for (size_t i = 0; i != num_latency_buckets; ++i) {
+		if (this->latency_histogram[i] == 0) {
+			continue;
+		}
+		o << "latency_ns." << (i == 0 ? 0 : (uint64_t(1) << i)) << ' ' << this->latency_histogram[i] << '\n';
+	}
+}
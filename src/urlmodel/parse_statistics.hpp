@@ -0,0 +1,113 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+namespace urlmodel {
+
+/**
+ * @brief URL parsing statistics.
+ * Collected by the parser in case its policy has 'instrumented' set to true.
+ * The statistics object is not thread-safe, so normally each thread has its own statistics object,
+ * the per-thread objects can be merged later with operator+=().
+ */
+struct parse_statistics {
+	/**
+   * @brief Parser state.
+   * Used to index per-state statistics.
+   */
+	enum class state {
+		scheme,
+		authority_prefix,
+		authority,
+		path,
+		query_name,
+		query_value,
+		fragment,
+
+		enum_size
+	};
+
+	constexpr static size_t num_states = size_t(state::enum_size);
+
+	// 2^63 nanoseconds is about 292 years
+	constexpr static size_t num_latency_buckets = 64;
+
+	// number of bytes consumed in each parser state
+	std::array<uint64_t, num_states> bytes_per_state{};
+
+	// number of parse errors occurred in each parser state
+	std::array<uint64_t, num_states> errors_per_state{};
+
+	uint64_t num_feed_calls = 0;
+
+	// number of parsed URLs, including the ones where parsing stopped early due to wanted components mask
+	uint64_t num_urls = 0;
+
+	// number of reallocations of the parser's internal buffer
+	uint64_t num_buf_reallocations = 0;
+
+	// estimated number of parsed URL strings and containers which ended up heap-backed:
+	// strings not fitting into the small string buffer, allocated path vector and query map nodes.
+	// Reallocations of the same buffer are not counted, so this is not the exact number of heap allocations.
+	uint64_t num_url_heap_buffers = 0;
+
+	/**
+   * @brief Latency histogram.
+   * Bucket i contains number of URLs which took from 2^i to 2^(i + 1) - 1 nanoseconds to parse,
+   * bucket 0 also includes 0 nanoseconds.
+   * Only collected in case parser policy's 'measure_latency' is true.
+   */
+	std::array<uint64_t, num_latency_buckets> latency_histogram{};
+
+	/**
+   * @brief Add latency sample to the histogram.
+   * @param nanoseconds - latency of parsing one URL.
+   */
+	void add_latency(uint64_t nanoseconds) noexcept;
+
+	/**
+   * @brief Merge statistics.
+   * @param s - statistics to add to this one.
+   * @return reference to this statistics object.
+   */
+	parse_statistics& operator+=(const parse_statistics& s) noexcept;
+
+	/**
+   * @brief Export statistics.
+   * Writes statistics in text format, one "<name> <value>" pair per line.
+   * Per-state values are named as "<name>.<state>", latency histogram buckets are named as
+   * "latency_ns.<lower bucket boundary>" and only non-empty buckets are written.
+   * @param o - output stream to write the statistics to.
+   */
+	void write(std::ostream& o) const;
+};
+
+} // namespace urlmodel
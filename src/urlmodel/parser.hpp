@@ -26,17 +26,173 @@ SOFTWARE.
 
 #pragma once
 
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
 #include <utki/span.hpp>
 
+#include "parse_statistics.hpp"
 #include "url.hpp"
 
 namespace urlmodel {
 
+/**
+ * @brief Default URL parser policy.
+ * Custom policies can be derived from this one, overriding only the members which need to be changed.
+ */
+struct parser_policy {
+	/**
+   * @brief Type of input characters.
+   * Either char or uint8_t. In case of char, the parser also accepts std::string_view input.
+   */
+	using char_type = uint8_t;
+
+	/**
+   * @brief Strict parsing.
+   * If true, the characters allowed in each URL component and percent-encoding are checked
+   * according to RFC 3986.
+   * Otherwise, any characters except the component delimiters are accepted.
+   */
+	constexpr static bool strict = false;
+
+	/**
+   * @brief Whitespace terminates URL.
+   * If true, whitespace character terminates the URL and the parser state is set to 'end'.
+   * Otherwise, whitespace is treated as any other character and the URL is terminated only by end_of_data().
+   */
+	constexpr static bool whitespace_terminates = true;
+
+	/**
+   * @brief Collect parse statistics.
+   * If true, the parser updates the urlmodel::parse_statistics object passed to its constructor.
+   * Otherwise, all the instrumentation code is compiled out.
+   */
+	constexpr static bool instrumented = false;
+
+	/**
+   * @brief Measure latency of parsing each URL.
+   * Only has effect in case 'instrumented' is true.
+   * The latency is measured from the first feed() call till the end of URL is reached,
+   * so in case the URL is fed in portions, it also includes the time between the feed() calls.
+   */
+	constexpr static bool measure_latency = false;
+
+	/**
+   * @brief Validate UTF-8.
+   * If true, the URL bytes are checked to be valid UTF-8 as they are parsed, and urlmodel::utf8_error
+   * is thrown in case of invalid UTF-8 sequence. Also, the parser keeps track of which URL components
+   * are pure ASCII, see basic_parser::is_ascii().
+   * Otherwise, any bytes are accepted, except the ones forbidden by strict parsing.
+   */
+	constexpr static bool validate_utf8 = false;
+};
+
+/**
+ * @brief RFC 3986 strict parser policy.
+ */
+struct strict_parser_policy : public parser_policy {
+	constexpr static bool strict = true;
+};
+
+class uri_template;
+
+/**
+ * @brief Invalid UTF-8 error.
+ * Thrown by the parser in case parser policy's validate_utf8 is true and the URL is not a valid UTF-8.
+ */
+class utf8_error : public std::invalid_argument
+{
+public:
+	/**
+   * @brief Offset of the first invalid byte from the beginning of the URL.
+   */
+	size_t offset;
+
+	explicit utf8_error(size_t offset) :
+		std::invalid_argument("urlmodel: URL contains invalid UTF-8 at offset " + std::to_string(offset)),
+		offset(offset)
+	{}
+};
+
+namespace detail {
+// Incremental UTF-8 validator.
+// Keeps state between portions of data, so that multibyte sequences can be split between portions.
+class utf8_validator
+{
+	// number of continuation bytes left in the current multibyte sequence
+	uint8_t num_pending = 0;
+
+	// range of allowed values of the next continuation byte
+	uint8_t min = 0x80;
+	uint8_t max = 0xbf;
+
+public:
+	// Validates next portion of data.
+	// Returns index of the first invalid byte, or size of the data in case the data is valid.
+	// Sets has_non_ascii to true if the valid data contains non-ASCII bytes.
+	template <typename char_type>
+	size_t feed(const char_type* data, size_t size, bool& has_non_ascii) noexcept;
+
+	// checks if there is no unfinished multibyte sequence
+	bool is_complete() const noexcept
+	{
+		return this->num_pending == 0;
+	}
+};
+
+template <bool validate_utf8>
+struct parser_utf8_validation {};
+
+template <>
+struct parser_utf8_validation<true> {
+	utf8_validator utf8;
+
+	// number of bytes validated so far, i.e. offset of the next byte from the URL beginning
+	size_t num_validated_bytes = 0;
+
+	component_mask non_ascii_components = 0;
+
+	// parser state which consumed the last validated bytes, the state enum is private to the parser
+	uint8_t validated_state = 0;
+};
+
+template <bool instrumented, bool measure_latency>
+struct parser_instrumentation {};
+
+template <>
+struct parser_instrumentation<true, false> {
+	parse_statistics* statistics;
+};
+
+template <>
+struct parser_instrumentation<true, true> : public parser_instrumentation<true, false> {
+	bool is_started = false;
+	std::chrono::steady_clock::time_point start_time;
+};
+} // namespace detail
+
 // TODO: why lint complains?
 // "error: an exception may be thrown in function 'parser'"
 // NOLINTNEXTLINE(bugprone-exception-escape)
-class parser
+template <typename policy_type>
+class basic_parser :
+	// empty bases in case instrumentation or UTF-8 validation is off, so they take no space
+	private detail::parser_instrumentation<policy_type::instrumented, policy_type::measure_latency>,
+	private detail::parser_utf8_validation<policy_type::validate_utf8>
 {
+public:
+	using char_type = typename policy_type::char_type;
+
+	static_assert(
+		std::is_same_v<char_type, char> || std::is_same_v<char_type, uint8_t>,
+		"parser policy char_type must be char or uint8_t"
+	);
+
+private:
+	// NOTE: the order of states must be the same as in parse_statistics::state
 	enum class state {
 		scheme,
 		authority_prefix,
@@ -48,21 +204,49 @@ class parser
 		end
 	};
 
+	static_assert(size_t(state::end) == parse_statistics::num_states, "parser states mismatch statistics states");
+
 	state cur_state = state::scheme;
 
+	component_mask wanted_components;
+
+	// components which can be parsed after entering the given state
+	static component_mask get_remaining_components(state s) noexcept;
+
 	std::vector<uint8_t> buf;
 
-	utki::span<const uint8_t> parse_scheme(utki::span<const uint8_t> data);
-	utki::span<const uint8_t> parse_authority_prefix(utki::span<const uint8_t> data);
-	utki::span<const uint8_t> parse_authority(utki::span<const uint8_t> data);
-	utki::span<const uint8_t> parse_path(utki::span<const uint8_t> data);
-	utki::span<const uint8_t> parse_query_name(utki::span<const uint8_t> data);
-	utki::span<const uint8_t> parse_query_value(utki::span<const uint8_t> data);
-	utki::span<const uint8_t> parse_fragment(utki::span<const uint8_t> data);
+	utki::span<const char_type> parse_scheme(utki::span<const char_type> data);
+	utki::span<const char_type> parse_authority_prefix(utki::span<const char_type> data);
+	utki::span<const char_type> parse_authority(utki::span<const char_type> data);
+	utki::span<const char_type> parse_path(utki::span<const char_type> data);
+	utki::span<const char_type> parse_query_name(utki::span<const char_type> data);
+	utki::span<const char_type> parse_query_value(utki::span<const char_type> data);
+	utki::span<const char_type> parse_fragment(utki::span<const char_type> data);
 
 	void handle_end_of_authority();
 	void handle_end_of_path_segment();
 	void handle_end_of_query_value();
+	void handle_end_of_fragment();
+	void handle_end_of_url();
+
+	void push_to_buf(uint8_t c);
+	void finish_url();
+
+	// URL component which is parsed in the given state, authority components are handled separately
+	static component_mask get_component(state s) noexcept;
+
+	void check_utf8(state s, utki::span<const char_type> data);
+	void check_utf8_complete() const;
+
+	// counts parse error in statistics
+	void count_error(bool is_utf8_error) noexcept;
+
+	utki::span<const char_type> parse(utki::span<const char_type> data);
+
+	// Appends the string to the URL component being parsed without scanning it.
+	// The string must not contain delimiters, e.g. percent-encoded URI template variable values.
+	friend class urlmodel::uri_template;
+	void append_to_component(std::string_view str);
 
 	// for storing query name until query value is parsed
 	std::string parsed_query_name;
@@ -70,6 +254,33 @@ class parser
 public:
 	urlmodel::url url;
 
+	/**
+   * @brief Constructor.
+   * Only the wanted URL components are stored to the resulting url object, other components are skipped
+   * with a fast scan, without storing and validating them. As soon as all the wanted components are parsed,
+   * the parser state is set to 'end' and feed() returns the rest of the data, which starts right after the
+   * delimiter which ends the last wanted component.
+   * E.g. in case only component::host and component::port are wanted, the parsing ends at the end of URL authority.
+   * @param wanted_components - bitmask of URL components to parse, see urlmodel::component.
+   */
+	template <bool instrumented = policy_type::instrumented, std::enable_if_t<!instrumented, bool> = true>
+	explicit basic_parser(component_mask wanted_components = component::all) noexcept :
+		wanted_components(wanted_components)
+	{}
+
+	/**
+   * @brief Constructor of instrumented parser.
+   * Only available in case parser policy's 'instrumented' is true.
+   * @param statistics - statistics object to update during parsing. It must outlive the parser.
+   * @param wanted_components - bitmask of URL components to parse, see urlmodel::component.
+   */
+	template <bool instrumented = policy_type::instrumented, std::enable_if_t<instrumented, bool> = true>
+	explicit basic_parser(parse_statistics& statistics, component_mask wanted_components = component::all) noexcept :
+		wanted_components(wanted_components)
+	{
+		this->statistics = &statistics;
+	}
+
 	/**
    * @brief Feed data portion to parse.
    * @param data - portion of data to parse.
@@ -77,7 +288,21 @@ public:
    *     URI end has been encountered in the middle of the fed data.
    * @throw std::invalid_argument in case of malformed URL.
    */
-	utki::span<const uint8_t> feed(utki::span<const uint8_t> data);
+	utki::span<const char_type> feed(utki::span<const char_type> data);
+
+	/**
+   * @brief Feed string portion to parse.
+   * Only available when parser policy's char_type is char.
+   * @param str - portion of data to parse.
+   * @return part of the string remained after parsing.
+   * @throw std::invalid_argument in case of malformed URL.
+   */
+	template <typename c_type = char_type, std::enable_if_t<std::is_same_v<c_type, char>, bool> = true>
+	std::string_view feed(std::string_view str)
+	{
+		auto rest = this->feed(utki::make_span(str.data(), str.size()));
+		return str.substr(str.size() - rest.size());
+	}
 
 	/**
    * @brief End of input data reached.
@@ -85,6 +310,7 @@ public:
    * parser state will be set to 'end'. This function doesn't have to be called
    * in case URL is terminated by a whitespace, in this case parser state will
    * be set to 'end' when this whitespace is reached.
+   * @throw std::invalid_argument in case URL cannot end at this point.
    */
 	void end_of_data();
 
@@ -97,6 +323,35 @@ public:
 	{
 		return this->cur_state == state::end;
 	}
+
+	/**
+   * @brief Check if URL components are pure ASCII.
+   * Only available when parser policy's validate_utf8 is true.
+   * Consumers of the parsed URL can use this to skip their own UTF-8 validation of pure ASCII strings.
+   * Only the wanted components are tracked, the components which were not parsed are reported as ASCII.
+   * @param components - bitmask of URL components to check, see urlmodel::component.
+   * @return true if all the given components, parsed so far, contain only ASCII characters.
+   * @return false otherwise.
+   */
+	template <bool validate_utf8 = policy_type::validate_utf8, std::enable_if_t<validate_utf8, bool> = true>
+	bool is_ascii(component_mask components) const noexcept
+	{
+		return (this->non_ascii_components & components) == 0;
+	}
 };
 
+/**
+ * @brief URL parser with default policy.
+ */
+using parser = basic_parser<parser_policy>;
+
+} // namespace urlmodel
+
+#include "parser_impl.hpp"
+
+#ifndef URLMODEL_HEADER_ONLY
+namespace urlmodel {
+// the default parser is compiled into the library
+extern template class basic_parser<parser_policy>;
 } // namespace urlmodel
+#endif
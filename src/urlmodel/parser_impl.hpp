@@ -0,0 +1,1100 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include "parser.hpp"
+
+#include <array>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
+#include <utki/string.hpp>
+
+namespace urlmodel::detail {
+
+// character classes according to RFC 3986, used for strict parsing
+enum char_class : uint8_t {
+	// reg-name: unreserved / pct-encoded / sub-delims
+	host = 1 << 0,
+	// reg-name characters and ':'
+	userinfo = 1 << 1,
+	// userinfo characters and '@', '[', ']'
+	authority = 1 << 2,
+	// pchar: reg-name characters and ':', '@'
+	path = 1 << 3,
+	// pchar and '/', '?', also used for fragment
+	query = 1 << 4
+};
+
+constexpr std::array<uint8_t, 256> make_char_classes()
+{
+	std::array<uint8_t, 256> ret{};
+
+	auto add = [&ret](std::string_view chars, uint8_t classes) {
+		for (auto c : chars) {
+			ret[uint8_t(c)] |= classes;
+		}
+	};
+
+	constexpr uint8_t all = host | userinfo | authority | path | query;
+
+	// unreserved
+	add("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~", all);
+
+	// pct-encoded, the encoded octet itself is checked separately
+	add("%", all);
+
+	// sub-delims
+	add("!$&'()*+,;=", all);
+
+	add(":", userinfo | authority | path | query);
+	add("@", authority | path | query);
+	add("[]", authority);
+	add("/?", query);
+
+	return ret;
+}
+
+inline constexpr auto char_classes = make_char_classes();
+
+inline bool has_char_class(char c, char_class cls) noexcept
+{
+	return (char_classes[uint8_t(c)] & cls) != 0;
+}
+
+// same as std::isspace() for classic locale
+constexpr bool is_space(char c) noexcept
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+constexpr bool is_alpha(char c) noexcept
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+constexpr bool is_digit(char c) noexcept
+{
+	return c >= '0' && c <= '9';
+}
+
+constexpr bool is_hex_digit(char c) noexcept
+{
+	return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+constexpr char to_lower(char c) noexcept
+{
+	if (c >= 'A' && c <= 'Z') {
+		return char(c - 'A' + 'a');
+	}
+	return c;
+}
+
+[[noreturn]] inline void throw_forbidden_char(char c, std::string_view component)
+{
+	std::stringstream ss;
+	ss << "urlmodel: URL " << component << " contains forbidden character: " << c;
+	throw std::invalid_argument(ss.str());
+}
+
+inline void check_chars(std::string_view str, char_class cls, std::string_view component)
+{
+	for (auto c : str) {
+		if (!has_char_class(c, cls)) {
+			throw_forbidden_char(c, component);
+		}
+	}
+}
+
+inline void check_percent_encoding(std::string_view str, std::string_view component)
+{
+	for (size_t i = 0; i != str.size(); ++i) {
+		if (str[i] != '%') {
+			continue;
+		}
+
+		if (i + 2 >= str.size()) {
+			std::stringstream ss;
+			ss << "urlmodel: URL " << component << " contains incomplete percent-encoding";
+			throw std::invalid_argument(ss.str());
+		}
+
+		if (!is_hex_digit(str[i + 1]) || !is_hex_digit(str[i + 2])) {
+			std::stringstream ss;
+			ss << "urlmodel: URL " << component << " contains malformed percent-encoding";
+			throw std::invalid_argument(ss.str());
+		}
+
+		i += 2;
+	}
+}
+
+// Finds first delimiter character, or whitespace in case stop_at_space is true, starting from position i.
+// Returns size of the data if not found.
+template <bool stop_at_space, char... delimiters, typename char_type>
+size_t find_end(const char_type* data, size_t i, size_t size) noexcept
+{
+	static_assert(sizeof(char_type) == 1, "char_type must be one byte");
+
+#if defined(__SSE2__)
+	const auto space = _mm_set1_epi8(' ');
+	const auto tab = _mm_set1_epi8('\t');
+
+	// whitespace characters other than space are in range from '\t' to '\r'
+	const auto max_offset_from_tab = _mm_set1_epi8('\r' - '\t');
+
+	for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+		auto matches = _mm_setzero_si128();
+
+		if constexpr (stop_at_space) {
+			auto offset_from_tab = _mm_sub_epi8(v, tab);
+			matches = _mm_or_si128(
+				_mm_cmpeq_epi8(v, space),
+				_mm_cmpeq_epi8(_mm_min_epu8(offset_from_tab, max_offset_from_tab), offset_from_tab)
+			);
+		}
+
+		((matches = _mm_or_si128(matches, _mm_cmpeq_epi8(v, _mm_set1_epi8(delimiters)))), ...);
+
+		auto mask = unsigned(_mm_movemask_epi8(matches));
+		if (mask != 0) {
+			return i + unsigned(__builtin_ctz(mask));
+		}
+	}
+#endif
+
+	for (; i != size; ++i) {
+		auto c = char(data[i]);
+		if ((stop_at_space && is_space(c)) || ((c == delimiters) || ...)) {
+			return i;
+		}
+	}
+	return size;
+}
+
+inline bool is_ascii(std::string_view str) noexcept
+{
+	for (auto c : str) {
+		if (uint8_t(c) >= 0x80) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename char_type>
+size_t utf8_validator::feed(const char_type* data, size_t size, bool& has_non_ascii) noexcept
+{
+	static_assert(sizeof(char_type) == 1, "char_type must be one byte");
+
+	size_t i = 0;
+	while (i != size) {
+		if (this->num_pending != 0) {
+			auto c = uint8_t(data[i]);
+			if (c < this->min || c > this->max) {
+				return i;
+			}
+			this->min = 0x80;
+			this->max = 0xbf;
+			--this->num_pending;
+			++i;
+			has_non_ascii = true;
+			continue;
+		}
+
+		// skip ASCII characters
+
+#if defined(__SSE2__)
+		for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+			// most significant bit is set in non-ASCII bytes
+			if (_mm_movemask_epi8(v) != 0) {
+				break;
+			}
+		}
+#endif
+
+		for (; i != size && uint8_t(data[i]) < 0x80; ++i) {
+		}
+
+		if (i == size) {
+			break;
+		}
+
+		has_non_ascii = true;
+
+		// multibyte sequence lead byte, see RFC 3629 section 4 for allowed byte sequences
+		auto c = uint8_t(data[i]);
+		if (c >= 0xc2 && c <= 0xdf) {
+			this->num_pending = 1;
+		} else if (c == 0xe0) {
+			// overlong encoding
+			this->num_pending = 2;
+			this->min = 0xa0;
+		} else if (c == 0xed) {
+			// surrogates
+			this->num_pending = 2;
+			this->max = 0x9f;
+		} else if (c >= 0xe1 && c <= 0xef) {
+			this->num_pending = 2;
+		} else if (c == 0xf0) {
+			// overlong encoding
+			this->num_pending = 3;
+			this->min = 0x90;
+		} else if (c >= 0xf1 && c <= 0xf3) {
+			this->num_pending = 3;
+		} else if (c == 0xf4) {
+			// code points above U+10FFFF
+			this->num_pending = 3;
+			this->max = 0x8f;
+		} else {
+			return i;
+		}
+		++i;
+	}
+	return size;
+}
+
+} // namespace urlmodel::detail
+
+namespace urlmodel {
+
+template <typename policy_type>
+auto basic_parser<policy_type>::parse_scheme(utki::span<const char_type> data) -> utki::span<const char_type>
+{
+	auto i = data.begin();
+	for (; i != data.end(); ++i) {
+		auto c = detail::to_lower(char(*i));
+
+		if (c == '/') {
+			// start parsing path without scheme and authority
+			this->cur_state = state::path;
+			++i;
+			break;
+		} else if (c == ':') {
+			// end of scheme
+			if (this->wanted_components & component::scheme) {
+				this->url.scheme = utki::make_string(this->buf);
+			}
+			this->buf.clear();
+			this->cur_state = state::authority_prefix;
+			++i;
+			break;
+		}
+
+		if (this->buf.empty()) {
+			if (!detail::is_alpha(c)) {
+				std::stringstream ss;
+				ss << "urlmodel: first char of URL scheme is not alphabethic: " << c;
+				throw std::invalid_argument(ss.str());
+			}
+		} else {
+			if (!(detail::is_alpha(c) || detail::is_digit(c) || c == '+' || c == '-' || c == '.')) {
+				std::stringstream ss;
+				ss << "urlmodel: URL scheme contains forbidden character: " << c;
+				throw std::invalid_argument(ss.str());
+			}
+		}
+
+		this->push_to_buf(uint8_t(c));
+	}
+	data = data.subspan(std::distance(data.begin(), i));
+	return data;
+}
+
+template <typename policy_type>
+auto basic_parser<policy_type>::parse_authority_prefix(utki::span<const char_type> data) -> utki::span<const char_type>
+{
+	auto i = data.begin();
+	for (; i != data.end(); ++i) {
+		auto c = char(*i);
+
+		if (c != '/') {
+			if constexpr (policy_type::whitespace_terminates) {
+				if (detail::is_space(c)) {
+					ASSERT(this->buf.empty() || (this->buf.size() == 1 && this->buf[0] == '/'))
+					this->handle_end_of_url();
+					break;
+				}
+			}
+
+			if (c == '?') {
+				ASSERT(this->buf.empty() || (this->buf.size() == 1 && this->buf[0] == '/'))
+
+				// the path will be empty in any case, even if one '/' was present
+				// before '?'
+
+				this->buf.clear();
+				this->cur_state = state::query_name;
+				++i;
+				break;
+			} else if (c == '#') {
+				ASSERT(this->buf.empty() || (this->buf.size() == 1 && this->buf[0] == '/'))
+
+				// the path will be empty in any case, even if one '/' was present
+				// before '?'
+
+				this->buf.clear();
+				this->cur_state = state::fragment;
+				++i;
+				break;
+			} else if (this->buf.size() == 1) {
+				ASSERT(this->buf[0] == '/')
+				// path starts with single '/' character
+				this->buf.clear();
+				this->cur_state = state::path;
+				break;
+			}
+			throw std::invalid_argument("urlmodel: authority must start with // or be absent");
+		}
+
+		ASSERT(this->buf.size() <= 1)
+
+		if (this->buf.empty()) {
+			this->push_to_buf('/');
+			continue;
+		}
+
+		ASSERT(this->buf.size() == 1)
+		ASSERT(this->buf[0] == '/')
+
+		this->buf.clear();
+		this->cur_state = state::authority;
+		++i;
+		break;
+	}
+	data = data.subspan(std::distance(data.begin(), i));
+	return data;
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::handle_end_of_authority()
+{
+	if (!(this->wanted_components & (component::userinfo | component::host | component::port))) {
+		ASSERT(this->buf.empty())
+		return;
+	}
+
+	auto str = utki::make_string_view(this->buf);
+
+	auto at_pos = str.find('@');
+	if (at_pos != std::string_view::npos) {
+		ASSERT(at_pos < str.size())
+		// there is user info in the authority
+
+		if (this->wanted_components & component::userinfo) {
+			auto userinfo = str.substr(0, at_pos);
+
+			if constexpr (policy_type::strict) {
+				detail::check_chars(userinfo, detail::char_class::userinfo, "userinfo");
+				detail::check_percent_encoding(userinfo, "userinfo");
+			}
+
+			if constexpr (policy_type::validate_utf8) {
+				if (!detail::is_ascii(userinfo)) {
+					this->non_ascii_components |= component::userinfo;
+				}
+			}
+
+			utki::string_parser p(userinfo);
+
+			this->url.username = p.read_chars_until(':');
+
+			if (!p.empty()) {
+				// skip ':'
+				p.read_char();
+
+				this->url.password = p.read_chars(p.size());
+			}
+		}
+
+		str = str.substr(at_pos + 1);
+	}
+
+	utki::string_parser p(str);
+
+	auto host = p.read_chars_until(':');
+
+	if (this->wanted_components & component::host) {
+		if constexpr (policy_type::strict) {
+			detail::check_chars(host, detail::char_class::host, "host");
+			detail::check_percent_encoding(host, "host");
+		}
+
+		if constexpr (policy_type::validate_utf8) {
+			if (!detail::is_ascii(host)) {
+				this->non_ascii_components |= component::host;
+			}
+		}
+
+		this->url.host = host;
+	}
+
+	if (!p.empty() && (this->wanted_components & component::port)) {
+		// skip ':'
+		p.read_char();
+
+		this->url.port = p.read_number<uint16_t>();
+
+		if (this->url.port == 0) {
+			throw std::invalid_argument("urlmodel: invalid port specified in URL: 0");
+		}
+
+		if constexpr (policy_type::strict) {
+			if (!p.empty()) {
+				throw std::invalid_argument("urlmodel: URL port contains forbidden characters");
+			}
+		}
+	}
+
+	this->buf.clear();
+}
+
+template <typename policy_type>
+auto basic_parser<policy_type>::parse_authority(utki::span<const char_type> data) -> utki::span<const char_type>
+{
+	auto i = data.begin();
+
+	if (!(this->wanted_components & (component::userinfo | component::host | component::port))) {
+		// skip till the end of the component without storing it
+		std::advance(i, detail::find_end<policy_type::whitespace_terminates, '/', '?', '#'>(data.data(), 0, data.size()));
+	}
+
+	for (; i != data.end(); ++i) {
+		auto c = char(*i);
+
+		if constexpr (policy_type::whitespace_terminates) {
+			if (detail::is_space(c)) {
+				this->handle_end_of_url();
+				break;
+			}
+		}
+
+		if (c == '/') {
+			this->handle_end_of_authority();
+			this->cur_state = state::path;
+			++i;
+			break;
+		} else if (c == '?') {
+			this->handle_end_of_authority();
+			this->cur_state = state::query_name;
+			++i;
+			break;
+		} else if (c == '#') {
+			this->handle_end_of_authority();
+			this->cur_state = state::fragment;
+			++i;
+			break;
+		}
+
+		if constexpr (policy_type::strict) {
+			if (!detail::has_char_class(c, detail::char_class::authority)) {
+				detail::throw_forbidden_char(c, "authority");
+			}
+		}
+
+		this->push_to_buf(uint8_t(c));
+	}
+	data = data.subspan(std::distance(data.begin(), i));
+	return data;
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::handle_end_of_path_segment()
+{
+	if (this->buf.empty()) {
+		return;
+	}
+
+	if constexpr (policy_type::strict) {
+		detail::check_percent_encoding(utki::make_string_view(this->buf), "path");
+	}
+
+	if (this->wanted_components & component::path) {
+		this->url.path.push_back(utki::make_string(this->buf));
+	}
+	this->buf.clear();
+}
+
+template <typename policy_type>
+auto basic_parser<policy_type>::parse_path(utki::span<const char_type> data) -> utki::span<const char_type>
+{
+	auto i = data.begin();
+
+	if (!(this->wanted_components & component::path)) {
+		// skip till the end of the component without storing it
+		std::advance(i, detail::find_end<policy_type::whitespace_terminates, '?', '#'>(data.data(), 0, data.size()));
+	}
+
+	for (; i != data.end(); ++i) {
+		auto c = char(*i);
+
+		if constexpr (policy_type::whitespace_terminates) {
+			if (detail::is_space(c)) {
+				this->handle_end_of_url();
+				break;
+			}
+		}
+
+		if (c == '/') {
+			this->handle_end_of_path_segment();
+			continue;
+		} else if (c == '?') {
+			this->handle_end_of_path_segment();
+			this->cur_state = state::query_name;
+			++i;
+			break;
+		} else if (c == '#') {
+			this->handle_end_of_path_segment();
+			this->cur_state = state::fragment;
+			++i;
+			break;
+		}
+
+		if constexpr (policy_type::strict) {
+			if (!detail::has_char_class(c, detail::char_class::path)) {
+				detail::throw_forbidden_char(c, "path");
+			}
+		}
+
+		this->push_to_buf(uint8_t(c));
+	}
+	data = data.subspan(std::distance(data.begin(), i));
+	return data;
+}
+
+template <typename policy_type>
+auto basic_parser<policy_type>::parse_query_name(utki::span<const char_type> data) -> utki::span<const char_type>
+{
+	auto i = data.begin();
+
+	if (!(this->wanted_components & component::query)) {
+		// skip till the end of the component without storing it
+		std::advance(i, detail::find_end<policy_type::whitespace_terminates, '='>(data.data(), 0, data.size()));
+	}
+
+	for (; i != data.end(); ++i) {
+		auto c = char(*i);
+
+		if constexpr (policy_type::whitespace_terminates) {
+			if (detail::is_space(c)) {
+				this->handle_end_of_url();
+				break;
+			}
+		}
+
+		if (c == '=') {
+			if constexpr (policy_type::strict) {
+				detail::check_percent_encoding(utki::make_string_view(this->buf), "query");
+			}
+
+			this->parsed_query_name = utki::make_string(this->buf);
+			this->buf.clear();
+			this->cur_state = state::query_value;
+			++i;
+			break;
+		}
+
+		if constexpr (policy_type::strict) {
+			if (!detail::has_char_class(c, detail::char_class::query)) {
+				detail::throw_forbidden_char(c, "query");
+			}
+		}
+
+		this->push_to_buf(uint8_t(c));
+	}
+	data = data.subspan(std::distance(data.begin(), i));
+	return data;
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::handle_end_of_query_value()
+{
+	if (!(this->wanted_components & component::query)) {
+		ASSERT(this->buf.empty())
+		return;
+	}
+
+	if constexpr (policy_type::strict) {
+		detail::check_percent_encoding(utki::make_string_view(this->buf), "query");
+	}
+
+	this->url.query.insert_or_assign(std::move(this->parsed_query_name), utki::make_string(this->buf));
+	this->parsed_query_name.clear();
+	this->buf.clear();
+}
+
+template <typename policy_type>
+auto basic_parser<policy_type>::parse_query_value(utki::span<const char_type> data) -> utki::span<const char_type>
+{
+	auto i = data.begin();
+
+	if (!(this->wanted_components & component::query)) {
+		// skip till the end of the component without storing it
+		std::advance(i, detail::find_end<policy_type::whitespace_terminates, '&', '#'>(data.data(), 0, data.size()));
+	}
+
+	for (; i != data.end(); ++i) {
+		auto c = char(*i);
+
+		if constexpr (policy_type::whitespace_terminates) {
+			if (detail::is_space(c)) {
+				this->handle_end_of_url();
+				break;
+			}
+		}
+
+		if (c == '&') {
+			this->handle_end_of_query_value();
+			this->cur_state = state::query_name;
+			++i;
+			break;
+		} else if (c == '#') {
+			this->handle_end_of_query_value();
+			this->cur_state = state::fragment;
+			++i;
+			break;
+		}
+
+		if constexpr (policy_type::strict) {
+			if (!detail::has_char_class(c, detail::char_class::query)) {
+				detail::throw_forbidden_char(c, "query");
+			}
+		}
+
+		this->push_to_buf(uint8_t(c));
+	}
+	data = data.subspan(std::distance(data.begin(), i));
+	return data;
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::handle_end_of_fragment()
+{
+	if (!(this->wanted_components & component::fragment)) {
+		ASSERT(this->buf.empty())
+		return;
+	}
+
+	if constexpr (policy_type::strict) {
+		detail::check_percent_encoding(utki::make_string_view(this->buf), "fragment");
+	}
+
+	this->url.fragment = utki::make_string(this->buf);
+	this->buf.clear();
+}
+
+template <typename policy_type>
+auto basic_parser<policy_type>::parse_fragment(utki::span<const char_type> data) -> utki::span<const char_type>
+{
+	auto i = data.begin();
+
+	if (!(this->wanted_components & component::fragment)) {
+		// skip till the end of the component without storing it
+		std::advance(i, detail::find_end<policy_type::whitespace_terminates>(data.data(), 0, data.size()));
+	}
+
+	for (; i != data.end(); ++i) {
+		auto c = char(*i);
+
+		if constexpr (policy_type::whitespace_terminates) {
+			if (detail::is_space(c)) {
+				this->handle_end_of_url();
+				break;
+			}
+		}
+
+		if constexpr (policy_type::strict) {
+			// fragment has the same set of allowed characters as query
+			if (!detail::has_char_class(c, detail::char_class::query)) {
+				detail::throw_forbidden_char(c, "fragment");
+			}
+		}
+
+		this->push_to_buf(uint8_t(c));
+	}
+	data = data.subspan(std::distance(data.begin(), i));
+	return data;
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::push_to_buf(uint8_t c)
+{
+	if constexpr (policy_type::instrumented) {
+		auto capacity = this->buf.capacity();
+		this->buf.push_back(c);
+		if (this->buf.capacity() != capacity) {
+			++this->statistics->num_buf_reallocations;
+		}
+	} else {
+		this->buf.push_back(c);
+	}
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::finish_url()
+{
+	this->cur_state = state::end;
+
+	if constexpr (policy_type::instrumented) {
+		auto& stats = *this->statistics;
+
+		++stats.num_urls;
+
+		// count heap-backed strings, i.e. the ones which did not fit into small string buffer
+		const auto small_string_capacity = std::string().capacity();
+		auto count = [&stats, small_string_capacity](const std::string& str) {
+			if (str.capacity() > small_string_capacity) {
+				++stats.num_url_heap_buffers;
+			}
+		};
+
+		count(this->url.scheme);
+		count(this->url.username);
+		count(this->url.password);
+		count(this->url.host);
+		count(this->url.fragment);
+
+		if (this->url.path.capacity() != 0) {
+			++stats.num_url_heap_buffers;
+		}
+		for (const auto& s : this->url.path) {
+			count(s);
+		}
+
+		for (const auto& q : this->url.query) {
+			// map node
+			++stats.num_url_heap_buffers;
+			count(q.first);
+			count(q.second);
+		}
+
+		if constexpr (policy_type::measure_latency) {
+			stats.add_latency(uint64_t(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start_time)
+					.count()
+			));
+		}
+	}
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::handle_end_of_url()
+{
+	if (this->cur_state == state::end) {
+		return;
+	}
+
+	if (!(this->wanted_components & get_remaining_components(this->cur_state))) {
+		// all wanted components are already parsed
+		this->buf.clear();
+		this->finish_url();
+		return;
+	}
+
+	switch (this->cur_state) {
+		case state::scheme:
+			throw std::invalid_argument("urlmodel: unexpected end of URL while parsing scheme");
+		case state::authority_prefix:
+			this->buf.clear();
+			break;
+		case state::authority:
+			this->handle_end_of_authority();
+			break;
+		case state::path:
+			this->handle_end_of_path_segment();
+			break;
+		case state::query_name:
+			if (this->wanted_components & component::query) {
+				throw std::invalid_argument("urlmodel: unexpected end of URL while parsing query parameter name");
+			}
+			break;
+		case state::query_value:
+			this->handle_end_of_query_value();
+			break;
+		case state::fragment:
+			this->handle_end_of_fragment();
+			break;
+		case state::end:
+			ASSERT(false)
+			break;
+	}
+	this->finish_url();
+}
+
+template <typename policy_type>
+component_mask basic_parser<policy_type>::get_remaining_components(state s) noexcept
+{
+	switch (s) {
+		case state::scheme:
+			return component::all;
+		case state::authority_prefix:
+		case state::authority:
+			return component::userinfo | component::host | component::port | component::path | component::query |
+				component::fragment;
+		case state::path:
+			return component::path | component::query | component::fragment;
+		case state::query_name:
+		case state::query_value:
+			return component::query | component::fragment;
+		case state::fragment:
+			return component::fragment;
+		case state::end:
+			break;
+	}
+	return 0;
+}
+
+template <typename policy_type>
+component_mask basic_parser<policy_type>::get_component(state s) noexcept
+{
+	switch (s) {
+		case state::scheme:
+			return component::scheme;
+		case state::path:
+			return component::path;
+		case state::query_name:
+		case state::query_value:
+			return component::query;
+		case state::fragment:
+			return component::fragment;
+		case state::authority_prefix:
+		case state::authority:
+		case state::end:
+			break;
+	}
+	return 0;
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::check_utf8(state s, utki::span<const char_type> data)
+{
+	// NOTE: the class is explicitly instantiated for policies without UTF-8 validation,
+	//       so the function body must compile for those as well
+	if constexpr (policy_type::validate_utf8) {
+		if (!data.empty()) {
+			this->validated_state = uint8_t(s);
+		}
+
+		bool has_non_ascii = false;
+
+		auto pos = this->utf8.feed(data.data(), data.size(), has_non_ascii);
+		if (pos != data.size()) {
+			throw utf8_error(this->num_validated_bytes + pos);
+		}
+
+		this->num_validated_bytes += data.size();
+
+		// the data can end with a delimiter, which is ASCII, so the non-ASCII characters belong to the component
+		// parsed in the given state
+		if (has_non_ascii) {
+			this->non_ascii_components |= get_component(s) & this->wanted_components;
+		}
+	}
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::check_utf8_complete() const
+{
+	if constexpr (policy_type::validate_utf8) {
+		if (!this->utf8.is_complete()) {
+			// the URL ends in the middle of multibyte sequence
+			throw utf8_error(this->num_validated_bytes);
+		}
+	}
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::count_error([[maybe_unused]] bool is_utf8_error) noexcept
+{
+	if constexpr (policy_type::instrumented) {
+		auto s = this->cur_state;
+
+		if constexpr (policy_type::validate_utf8) {
+			// UTF-8 is validated after the bytes are parsed, so the parser can already be in the next state,
+			// including the end state, count the error for the state which consumed the invalid bytes
+			if (is_utf8_error) {
+				s = state(this->validated_state);
+			}
+		}
+
+		ASSERT(s != state::end)
+		++this->statistics->errors_per_state[size_t(s)];
+	}
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::end_of_data()
+{
+	if constexpr (policy_type::instrumented) {
+		try {
+			this->handle_end_of_url();
+			this->check_utf8_complete();
+		} catch (utf8_error&) {
+			this->count_error(true);
+			throw;
+		} catch (std::invalid_argument&) {
+			this->count_error(false);
+			throw;
+		}
+	} else {
+		this->handle_end_of_url();
+		this->check_utf8_complete();
+	}
+}
+
+template <typename policy_type>
+void basic_parser<policy_type>::append_to_component(std::string_view str)
+{
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+	auto data = utki::make_span(reinterpret_cast<const char_type*>(str.data()), str.size());
+
+	if constexpr (policy_type::strict || policy_type::instrumented || policy_type::validate_utf8) {
+		// every character has to go through the parser
+		this->feed(data);
+	} else {
+		component_mask components = 0;
+
+		switch (this->cur_state) {
+			case state::scheme:
+			case state::authority_prefix:
+				// these states need to see every character
+				this->feed(data);
+				return;
+			case state::authority:
+				components = component::userinfo | component::host | component::port;
+				break;
+			case state::path:
+			case state::query_name:
+			case state::query_value:
+			case state::fragment:
+				components = get_component(this->cur_state);
+				break;
+			case state::end:
+				return;
+		}
+
+		if (!(this->wanted_components & components)) {
+			// the component is skipped
+			return;
+		}
+
+		this->buf.insert(this->buf.end(), data.begin(), data.end());
+	}
+}
+
+template <typename policy_type>
+auto basic_parser<policy_type>::feed(utki::span<const char_type> data) -> utki::span<const char_type>
+{
+	if constexpr (policy_type::instrumented) {
+		++this->statistics->num_feed_calls;
+
+		if constexpr (policy_type::measure_latency) {
+			if (!this->is_started) {
+				this->is_started = true;
+				this->start_time = std::chrono::steady_clock::now();
+			}
+		}
+
+		try {
+			return this->parse(data);
+		} catch (utf8_error&) {
+			this->count_error(true);
+			throw;
+		} catch (std::invalid_argument&) {
+			this->count_error(false);
+			throw;
+		}
+	} else {
+		return this->parse(data);
+	}
+}
+
+template <typename policy_type>
+auto basic_parser<policy_type>::parse(utki::span<const char_type> data) -> utki::span<const char_type>
+{
+	while (!data.empty()) {
+		if (!(this->wanted_components & get_remaining_components(this->cur_state))) {
+			// all wanted components are parsed
+			this->buf.clear();
+			this->finish_url();
+		}
+
+		[[maybe_unused]] auto prev_state = this->cur_state;
+		[[maybe_unused]] auto prev_data = data;
+
+		switch (this->cur_state) {
+			case state::scheme:
+				data = this->parse_scheme(data);
+				break;
+			case state::authority_prefix:
+				data = this->parse_authority_prefix(data);
+				break;
+			case state::authority:
+				data = this->parse_authority(data);
+				break;
+			case state::path:
+				data = this->parse_path(data);
+				break;
+			case state::query_name:
+				data = this->parse_query_name(data);
+				break;
+			case state::query_value:
+				data = this->parse_query_value(data);
+				break;
+			case state::fragment:
+				data = this->parse_fragment(data);
+				break;
+			case state::end:
+				if constexpr (policy_type::validate_utf8) {
+					this->check_utf8_complete();
+				}
+				return data;
+		}
+
+		if constexpr (policy_type::instrumented) {
+			this->statistics->bytes_per_state[size_t(prev_state)] += prev_data.size() - data.size();
+		}
+
+		if constexpr (policy_type::validate_utf8) {
+			this->check_utf8(prev_state, prev_data.subspan(0, prev_data.size() - data.size()));
+		}
+	}
+	return data;
+}
+
+} // namespace urlmodel
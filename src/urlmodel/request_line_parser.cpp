@@ -0,0 +1,307 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "request_line_parser.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#include <utki/string.hpp>
+
+using namespace urlmodel;
+
+namespace {
+// longest authority-form request-target: 255 characters of host name, ':' and 5 digits of port number
+constexpr size_t max_authority_size = 255 + 1 + 5;
+
+// limit method size, so that malicious client cannot make the parser consume unlimited memory,
+// standard methods are much shorter
+constexpr size_t max_method_size = 32;
+
+// token characters, see RFC 9110
+bool is_tchar(char c) noexcept
+{
+	if (detail::is_alpha(c) || detail::is_digit(c)) {
+		return true;
+	}
+	return std::string_view("!#$%&'*+-.^_`|~").find(c) != std::string_view::npos;
+}
+} // namespace
+
+utki::span<const uint8_t> request_line_parser::parse_method(utki::span<const uint8_t> data)
+{
+	auto i = data.begin();
+	for (; i != data.end(); ++i) {
+		auto c = char(*i);
+
+		if (c == ' ') {
+			if (this->method.empty()) {
+				throw std::invalid_argument("urlmodel: request-line: empty method");
+			}
+			this->cur_state = state::target_start;
+			++i;
+			break;
+		}
+
+		if (this->method.empty() && (c == '\r' || c == '\n')) {
+			// empty line before request-line, skip
+			continue;
+		}
+
+		if (!is_tchar(c)) {
+			std::stringstream ss;
+			ss << "urlmodel: request-line: method contains forbidden character: " << c;
+			throw std::invalid_argument(ss.str());
+		}
+
+		if (this->method.size() == max_method_size) {
+			throw std::invalid_argument("urlmodel: request-line: method is too long");
+		}
+
+		this->method.push_back(c);
+	}
+	data = data.subspan(std::distance(data.begin(), i));
+	return data;
+}
+
+utki::span<const uint8_t> request_line_parser::parse_target_start(utki::span<const uint8_t> data)
+{
+	ASSERT(!data.empty())
+
+	auto c = char(data.front());
+
+	if (this->method == "CONNECT") {
+		this->form = target_form::authority;
+		this->cur_state = state::authority;
+		return data;
+	}
+
+	if (c == '*') {
+		if (this->method != "OPTIONS") {
+			throw std::invalid_argument("urlmodel: request-line: asterisk-form request-target is only allowed with OPTIONS method");
+		}
+		this->form = target_form::asterisk;
+		this->cur_state = state::target_end;
+		return data.subspan(1);
+	}
+
+	if (c == '/') {
+		this->form = target_form::origin;
+	} else if (detail::is_alpha(c)) {
+		this->form = target_form::absolute;
+	} else {
+		std::stringstream ss;
+		ss << "urlmodel: request-line: request-target starts with forbidden character: " << c;
+		throw std::invalid_argument(ss.str());
+	}
+
+	this->cur_state = state::target;
+	return data;
+}
+
+utki::span<const uint8_t> request_line_parser::parse_target(utki::span<const uint8_t> data)
+{
+	data = this->target_parser.feed(data);
+
+	if (this->target_parser.is_end()) {
+		this->target = std::move(this->target_parser.url);
+		this->cur_state = state::target_skip;
+	}
+
+	return data;
+}
+
+utki::span<const uint8_t> request_line_parser::parse_target_skip(utki::span<const uint8_t> data)
+{
+	// URL parser stops right after the last wanted component, skip the rest of the request-target
+	auto i = detail::find_end<true>(data.data(), 0, data.size());
+	if (i != data.size()) {
+		this->cur_state = state::target_end;
+	}
+	return data.subspan(i);
+}
+
+void request_line_parser::handle_end_of_authority()
+{
+	std::string_view str = this->authority_buf;
+
+	auto colon_pos = str.rfind(':');
+	if (colon_pos == std::string_view::npos) {
+		throw std::invalid_argument("urlmodel: request-line: authority-form request-target has no port");
+	}
+
+	auto host = str.substr(0, colon_pos);
+	if (host.empty()) {
+		throw std::invalid_argument("urlmodel: request-line: authority-form request-target has empty host");
+	}
+	if (host.find('@') != std::string_view::npos) {
+		throw std::invalid_argument("urlmodel: request-line: authority-form request-target cannot have userinfo");
+	}
+
+	utki::string_parser p(str.substr(colon_pos + 1));
+
+	auto port = p.read_number<uint16_t>();
+
+	if (port == 0 || !p.empty()) {
+		throw std::invalid_argument("urlmodel: request-line: invalid port in authority-form request-target");
+	}
+
+	this->target.host = host;
+	this->target.port = port;
+
+	this->authority_buf.clear();
+}
+
+utki::span<const uint8_t> request_line_parser::parse_authority(utki::span<const uint8_t> data)
+{
+	auto i = detail::find_end<true>(data.data(), 0, data.size());
+
+	if (this->authority_buf.size() + i > max_authority_size) {
+		throw std::invalid_argument("urlmodel: request-line: authority-form request-target is too long");
+	}
+
+	this->authority_buf.append(utki::make_string_view(data.subspan(0, i)));
+
+	if (i != data.size()) {
+		this->handle_end_of_authority();
+		this->cur_state = state::target_end;
+	}
+
+	return data.subspan(i);
+}
+
+utki::span<const uint8_t> request_line_parser::parse_target_end(utki::span<const uint8_t> data)
+{
+	ASSERT(!data.empty())
+
+	auto c = char(data.front());
+
+	if (c == ' ') {
+		this->cur_state = state::version;
+		return data.subspan(1);
+	}
+
+	if (c == '\r' || c == '\n') {
+		throw std::invalid_argument("urlmodel: request-line: HTTP version is missing");
+	}
+
+	throw std::invalid_argument("urlmodel: request-line: request-target must be followed by single space");
+}
+
+void request_line_parser::handle_end_of_version()
+{
+	std::string_view str(this->version_buf.data(), this->version_buf_size);
+
+	// HTTP-version = "HTTP/" DIGIT "." DIGIT
+	if (str.size() != version_size || str.substr(0, 5) != "HTTP/" || !detail::is_digit(str[5]) || str[6] != '.' ||
+		!detail::is_digit(str[7]))
+	{
+		std::stringstream ss;
+		ss << "urlmodel: request-line: malformed HTTP version: " << str;
+		throw std::invalid_argument(ss.str());
+	}
+
+	this->version_major = uint8_t(str[5] - '0');
+	this->version_minor = uint8_t(str[7] - '0');
+}
+
+utki::span<const uint8_t> request_line_parser::parse_version(utki::span<const uint8_t> data)
+{
+	auto i = data.begin();
+	for (; i != data.end(); ++i) {
+		auto c = char(*i);
+
+		if (c == '\r') {
+			this->handle_end_of_version();
+			this->cur_state = state::line_feed;
+			++i;
+			break;
+		} else if (c == '\n') {
+			// bare LF line terminator is tolerated, see RFC 9112 section 2.2
+			this->handle_end_of_version();
+			this->cur_state = state::end;
+			++i;
+			break;
+		}
+
+		if (this->version_buf_size == this->version_buf.size()) {
+			throw std::invalid_argument("urlmodel: request-line: HTTP version is too long");
+		}
+
+		this->version_buf[this->version_buf_size] = c;
+		++this->version_buf_size;
+	}
+	data = data.subspan(std::distance(data.begin(), i));
+	return data;
+}
+
+utki::span<const uint8_t> request_line_parser::parse_line_feed(utki::span<const uint8_t> data)
+{
+	ASSERT(!data.empty())
+
+	if (data.front() != '\n') {
+		throw std::invalid_argument("urlmodel: request-line: CR is not followed by LF");
+	}
+
+	this->cur_state = state::end;
+	return data.subspan(1);
+}
+
+utki::span<const uint8_t> request_line_parser::feed(utki::span<const uint8_t> data)
+{
+	while (!data.empty()) {
+		switch (this->cur_state) {
+			case state::method:
+				data = this->parse_method(data);
+				break;
+			case state::target_start:
+				data = this->parse_target_start(data);
+				break;
+			case state::target:
+				data = this->parse_target(data);
+				break;
+			case state::target_skip:
+				data = this->parse_target_skip(data);
+				break;
+			case state::authority:
+				data = this->parse_authority(data);
+				break;
+			case state::target_end:
+				data = this->parse_target_end(data);
+				break;
+			case state::version:
+				data = this->parse_version(data);
+				break;
+			case state::line_feed:
+				data = this->parse_line_feed(data);
+				break;
+			case state::end:
+				return data;
+		}
+	}
+	return data;
+}
@@ -0,0 +1,154 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <utki/span.hpp>
+
+#include "parser.hpp"
+#include "url.hpp"
+
+namespace urlmodel {
+
+/**
+ * @brief HTTP/1.1 request-line parser.
+ * Parses request-line of the form "method SP request-target SP HTTP-version CRLF", see RFC 9112.
+ * The request-target is parsed by urlmodel::parser along the way, so the request-line bytes are scanned only once.
+ * The data can be fed in portions, as it comes from the network.
+ * Empty lines preceding the request-line are ignored.
+ */
+// TODO: why lint complains?
+// "error: an exception may be thrown in function 'request_line_parser'"
+// NOLINTNEXTLINE(bugprone-exception-escape)
+class request_line_parser
+{
+public:
+	/**
+   * @brief Form of request-target.
+   */
+	enum class target_form {
+		// absolute path with optional query, e.g. "/where?q=now"
+		origin,
+		// absolute URL, e.g. "http://www.example.org/pub/WWW/TheProject.html"
+		absolute,
+		// host and port, only used with CONNECT method, e.g. "www.example.com:80"
+		authority,
+		// "*", only used with OPTIONS method
+		asterisk
+	};
+
+private:
+	enum class state {
+		method,
+		target_start,
+		target,
+		target_skip,
+		authority,
+		target_end,
+		version,
+		line_feed,
+		end
+	};
+
+	state cur_state = state::method;
+
+	urlmodel::parser target_parser;
+
+	// for accumulating authority-form request-target
+	std::string authority_buf;
+
+	// "HTTP/x.y"
+	constexpr static size_t version_size = 8;
+	std::array<char, version_size> version_buf{};
+	size_t version_buf_size = 0;
+
+	utki::span<const uint8_t> parse_method(utki::span<const uint8_t> data);
+	utki::span<const uint8_t> parse_target_start(utki::span<const uint8_t> data);
+	utki::span<const uint8_t> parse_target(utki::span<const uint8_t> data);
+	utki::span<const uint8_t> parse_target_skip(utki::span<const uint8_t> data);
+	utki::span<const uint8_t> parse_authority(utki::span<const uint8_t> data);
+	utki::span<const uint8_t> parse_target_end(utki::span<const uint8_t> data);
+	utki::span<const uint8_t> parse_version(utki::span<const uint8_t> data);
+	utki::span<const uint8_t> parse_line_feed(utki::span<const uint8_t> data);
+
+	void handle_end_of_authority();
+	void handle_end_of_version();
+
+public:
+	/**
+   * @brief Request method, e.g. "GET".
+   * Methods longer than 32 characters are rejected as malformed.
+   */
+	std::string method;
+
+	target_form form = target_form::origin;
+
+	/**
+   * @brief Parsed request-target.
+   * In case of authority-form only host and port are set.
+   * In case of asterisk-form all components are empty.
+   */
+	urlmodel::url target;
+
+	uint8_t version_major = 0;
+	uint8_t version_minor = 0;
+
+	/**
+   * @brief Constructor.
+   * @param wanted_components - bitmask of request-target URL components to parse, see urlmodel::component.
+   *     The rest of the request-target is skipped without validation.
+   *     Does not apply to authority-form request-target.
+   */
+	explicit request_line_parser(component_mask wanted_components = component::all) noexcept :
+		target_parser(wanted_components)
+	{}
+
+	/**
+   * @brief Feed data portion to parse.
+   * @param data - portion of data to parse.
+   * @return span remained after parsing. It is non-empty in case the end of request-line,
+   *     i.e. the line terminator, has been encountered in the middle of the fed data.
+   *     The remained data starts right after the line terminator, i.e. with the request header fields.
+   * @throw std::invalid_argument in case of malformed request-line.
+   */
+	utki::span<const uint8_t> feed(utki::span<const uint8_t> data);
+
+	/**
+   * @brief Check if end of request-line is reached.
+   * @return true if end of request-line is reached.
+   * @return false otherwise.
+   */
+	bool is_end() const noexcept
+	{
+		return this->cur_state == state::end;
+	}
+};
+
+} // namespace urlmodel
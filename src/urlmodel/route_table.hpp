@@ -0,0 +1,381 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <utki/span.hpp>
+
+#include "mix.hpp"
+
+namespace urlmodel {
+
+namespace detail {
+
+// FNV-1a hash of path segments
+class path_hasher
+{
+	constexpr static uint64_t offset_basis = 0xcbf29ce484222325;
+	constexpr static uint64_t prime = 0x100000001b3;
+
+	uint64_t hash = offset_basis;
+
+public:
+	constexpr void add_segment(std::string_view segment) noexcept
+	{
+		for (auto c : segment) {
+			this->hash = (this->hash ^ uint8_t(c)) * prime;
+		}
+
+		// mix in the segment size, so that different splits of the same characters into segments
+		// give different hashes
+		this->hash = (this->hash ^ (uint64_t(segment.size()) << 8)) * prime;
+	}
+
+	constexpr uint64_t get() const noexcept
+	{
+		return this->hash;
+	}
+};
+
+// Reads '/' separated segments of the path given as a string.
+// Empty segments are skipped in the same way as urlmodel::parser does.
+class string_segment_reader
+{
+	std::string_view rest;
+
+public:
+	constexpr explicit string_segment_reader(std::string_view path) noexcept :
+		rest(path)
+	{}
+
+	// returns empty string when there are no more segments
+	constexpr std::string_view next() noexcept
+	{
+		auto begin = this->rest.find_first_not_of('/');
+		if (begin == std::string_view::npos) {
+			this->rest = std::string_view();
+			return this->rest;
+		}
+		this->rest = this->rest.substr(begin);
+
+		auto segment = this->rest.substr(0, this->rest.find('/'));
+		this->rest = this->rest.substr(segment.size());
+		return segment;
+	}
+};
+
+// reads segments of the path given as a sequence of segments, skipping empty ones
+class span_segment_reader
+{
+	utki::span<const std::string> path;
+	size_t i = 0;
+
+public:
+	explicit span_segment_reader(utki::span<const std::string> path) noexcept :
+		path(path)
+	{}
+
+	// returns empty string when there are no more segments
+	std::string_view next() noexcept
+	{
+		for (; this->i != this->path.size(); ++this->i) {
+			if (!this->path[this->i].empty()) {
+				return this->path[this->i++];
+			}
+		}
+		return std::string_view();
+	}
+};
+
+template <typename reader_type>
+constexpr uint64_t hash_path(reader_type reader) noexcept
+{
+	path_hasher h;
+	for (auto segment = reader.next(); !segment.empty(); segment = reader.next()) {
+		h.add_segment(segment);
+	}
+	return h.get();
+}
+
+template <typename reader_a_type, typename reader_b_type>
+constexpr bool is_same_path(reader_a_type a, reader_b_type b) noexcept
+{
+	for (;;) {
+		auto segment = a.next();
+		if (segment != b.next()) {
+			return false;
+		}
+		if (segment.empty()) {
+			return true;
+		}
+	}
+}
+
+constexpr size_t next_power_of_two(size_t n) noexcept
+{
+	size_t ret = 1;
+	while (ret < n) {
+		ret <<= 1;
+	}
+	return ret;
+}
+
+} // namespace detail
+
+/**
+ * @brief Static route table.
+ * Maps a fixed set of paths, known at compile time, to values.
+ * The table is built at compile time, in case it is declared as constexpr, using a perfect hash over the path segments,
+ * so looking up a path takes computing the hash of the path and one path comparison.
+ * Empty path segments are ignored, so "/api/users", "api/users" and "/api//users/" are the same path.
+ * Use make_route_table() to create the table.
+ * @tparam value_type - type of values. Has to be a literal type to build the table at compile time.
+ * @tparam num_routes - number of routes.
+ */
+template <typename value_type, size_t num_routes>
+class route_table
+{
+	static_assert(num_routes != 0, "route table must have at least one route");
+	static_assert(num_routes < std::numeric_limits<uint32_t>::max(), "too many routes");
+
+	using route_type = std::pair<std::string_view, value_type>;
+
+	// average bucket size is 2
+	constexpr static size_t num_buckets = num_routes / 2 + 1;
+
+	// load factor is between 0.4 and 0.8
+	constexpr static size_t table_size = detail::next_power_of_two(num_routes + num_routes / 4 + 1);
+
+	constexpr static uint32_t empty_slot = uint32_t(num_routes);
+
+	// limit number of tries to find bucket displacement, in case the perfect hash cannot be built
+	constexpr static uint32_t max_displacement = 1 << 20;
+
+	std::array<route_type, num_routes> routes;
+
+	// the 'hash, displace' perfect hashing: each hash bucket has its own displacement value which is
+	// selected so that all the routes of the bucket go to vacant slots of the table
+	std::array<uint32_t, num_buckets> displacements{};
+
+	// indices into routes array
+	std::array<uint32_t, table_size> slots{};
+
+	constexpr static size_t get_bucket(uint64_t hash) noexcept
+	{
+		return size_t(((hash >> 32) * num_buckets) >> 32);
+	}
+
+	constexpr static size_t get_slot(uint64_t hash, uint32_t displacement) noexcept
+	{
+		return size_t(detail::mix(hash ^ (uint64_t(displacement) * 0x9e3779b97f4a7c15))) & (table_size - 1);
+	}
+
+	template <size_t... indices>
+	constexpr route_table(const route_type (&routes)[num_routes], std::index_sequence<indices...>) :
+		routes{{routes[indices]...}}
+	{
+		std::array<uint64_t, num_routes> hashes{};
+		for (size_t r = 0; r != num_routes; ++r) {
+			hashes[r] = detail::hash_path(detail::string_segment_reader(this->routes[r].first));
+		}
+
+		// group routes by buckets
+
+		std::array<size_t, num_buckets + 1> bucket_begins{};
+		for (auto h : hashes) {
+			++bucket_begins[get_bucket(h) + 1];
+		}
+
+		size_t max_bucket_size = 0;
+		for (size_t b = 0; b != num_buckets; ++b) {
+			max_bucket_size = std::max(max_bucket_size, bucket_begins[b + 1]);
+			bucket_begins[b + 1] += bucket_begins[b];
+		}
+
+		std::array<uint32_t, num_routes> bucket_routes{};
+		{
+			auto positions = bucket_begins;
+			for (size_t r = 0; r != num_routes; ++r) {
+				auto& pos = positions[get_bucket(hashes[r])];
+				bucket_routes[pos] = uint32_t(r);
+				++pos;
+			}
+		}
+
+		// routes with equal hashes fall into the same bucket, so only compare routes within each bucket,
+		// buckets are small, so this is linear in the number of routes
+		for (size_t b = 0; b != num_buckets; ++b) {
+			for (auto i = bucket_begins[b]; i != bucket_begins[b + 1]; ++i) {
+				for (auto j = i + 1; j != bucket_begins[b + 1]; ++j) {
+					auto r1 = bucket_routes[i];
+					auto r2 = bucket_routes[j];
+					if (hashes[r1] != hashes[r2]) {
+						continue;
+					}
+					if (detail::is_same_path(
+							detail::string_segment_reader(this->routes[r1].first),
+							detail::string_segment_reader(this->routes[r2].first)
+						))
+					{
+						throw std::invalid_argument("urlmodel: route_table: duplicate route");
+					}
+					throw std::invalid_argument("urlmodel: route_table: route hash collision");
+				}
+			}
+		}
+
+		for (auto& s : this->slots) {
+			s = empty_slot;
+		}
+
+		// place bigger buckets first, while there are more vacant slots
+		for (size_t size = max_bucket_size; size != 0; --size) {
+			for (size_t b = 0; b != num_buckets; ++b) {
+				auto begin = bucket_begins[b];
+				auto end = bucket_begins[b + 1];
+
+				if (end - begin != size) {
+					continue;
+				}
+
+				for (uint32_t d = 0;; ++d) {
+					if (d == max_displacement) {
+						throw std::invalid_argument("urlmodel: route_table: could not build perfect hash");
+					}
+
+					auto i = begin;
+					for (; i != end; ++i) {
+						auto& slot = this->slots[get_slot(hashes[bucket_routes[i]], d)];
+						if (slot != empty_slot) {
+							break;
+						}
+						slot = bucket_routes[i];
+					}
+
+					if (i == end) {
+						this->displacements[b] = d;
+						break;
+					}
+
+					// roll back
+					for (auto j = begin; j != i; ++j) {
+						this->slots[get_slot(hashes[bucket_routes[j]], d)] = empty_slot;
+					}
+				}
+			}
+		}
+	}
+
+	template <typename reader_type>
+	constexpr std::optional<value_type> find_segments(reader_type reader) const
+	{
+		auto hash = detail::hash_path(reader);
+
+		auto slot = this->slots[get_slot(hash, this->displacements[get_bucket(hash)])];
+		if (slot == empty_slot) {
+			return std::nullopt;
+		}
+
+		const auto& r = this->routes[slot];
+		if (!detail::is_same_path(detail::string_segment_reader(r.first), reader)) {
+			return std::nullopt;
+		}
+
+		return r.second;
+	}
+
+public:
+	/**
+   * @brief Constructor.
+   * @param routes - array of route path and value pairs.
+   * @throw std::invalid_argument in case of duplicate routes. In case the table is built at compile time,
+   *     this results in compilation error.
+   */
+	constexpr explicit route_table(const route_type (&routes)[num_routes]) :
+		route_table(routes, std::make_index_sequence<num_routes>())
+	{}
+
+	/**
+   * @brief Find route.
+   * @param path - path segments, e.g. urlmodel::url::path.
+   * @return value of the route in case the path matches one of the routes.
+   * @return std::nullopt otherwise.
+   */
+	std::optional<value_type> find(utki::span<const std::string> path) const
+	{
+		return this->find_segments(detail::span_segment_reader(path));
+	}
+
+	/**
+   * @brief Find route.
+   * @param path - path as a string, e.g. "/api/users".
+   * @return value of the route in case the path matches one of the routes.
+   * @return std::nullopt otherwise.
+   */
+	constexpr std::optional<value_type> find(std::string_view path) const
+	{
+		return this->find_segments(detail::string_segment_reader(path));
+	}
+
+	constexpr static size_t size() noexcept
+	{
+		return num_routes;
+	}
+};
+
+/**
+ * @brief Create route table.
+ * Example:
+ * @code{.cpp}
+ * constexpr auto routes = urlmodel::make_route_table<int>({
+ *     {"/api/users", 1},
+ *     {"/api/groups", 2}
+ * });
+ *
+ * auto value = routes.find(url.path);
+ * @endcode
+ * @param routes - array of route path and value pairs.
+ * @return route table.
+ */
+template <typename value_type, size_t num_routes>
+constexpr route_table<value_type, num_routes> make_route_table(
+	const std::pair<std::string_view, value_type> (&routes)[num_routes]
+)
+{
+	return route_table<value_type, num_routes>(routes);
+}
+
+} // namespace urlmodel
@@ -0,0 +1,301 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "seen_set.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include <utki/debug.hpp>
+
+#include "mix.hpp"
+#include "url_hash.hpp"
+
+using namespace urlmodel;
+
+namespace {
+constexpr std::array<char, 8> magic = {'u', 'r', 'l', 'm', 's', 'e', 'e', 'n'};
+constexpr uint32_t format_version = 1;
+
+// stored in the first block of the set memory
+struct header {
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t num_hashes;
+	uint64_t num_blocks;
+};
+
+// number of URLs for which the filter memory is prefetched in advance during bulk operations
+constexpr size_t batch_size = 16;
+
+// generates positions of bits within a block for the URL hash,
+// independent from the high bits of the hash used for selecting the block
+class bit_generator
+{
+	constexpr static unsigned bits_per_position = 9;
+	constexpr static unsigned positions_per_word = 64 / bits_per_position;
+
+	uint64_t word;
+	unsigned num_left = positions_per_word;
+
+public:
+	explicit bit_generator(uint64_t hash) noexcept :
+		word(detail::mix(hash))
+	{}
+
+	uint32_t next() noexcept
+	{
+		if (this->num_left == 0) {
+			this->word = detail::mix(this->word + 0x9e3779b97f4a7c15);
+			this->num_left = positions_per_word;
+		}
+		--this->num_left;
+
+		auto ret = uint32_t(this->word % (uint64_t(1) << bits_per_position));
+		this->word >>= bits_per_position;
+		return ret;
+	}
+};
+
+void prefetch(const void* p) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(p);
+#endif
+}
+} // namespace
+
+seen_set::seen_set(uint64_t expected_num_urls, double false_positive_rate)
+{
+	if (expected_num_urls == 0) {
+		throw std::invalid_argument("urlmodel: seen_set: expected number of URLs must be greater than zero");
+	}
+
+	if (!(false_positive_rate > 0 && false_positive_rate < 1)) {
+		throw std::invalid_argument("urlmodel: seen_set: false positive rate must be in (0, 1) range");
+	}
+
+	const double ln2 = std::log(2.0);
+
+	// optimal number of bits per URL for the classic Bloom filter
+	double bits_per_url = -std::log(false_positive_rate) / (ln2 * ln2);
+
+	this->num_hashes = uint32_t(std::clamp(std::round(bits_per_url * ln2), 1.0, double(max_num_hashes)));
+
+	// blocked Bloom filter has higher false positive rate than the classic one because
+	// the URLs are not evenly distributed among blocks, compensate with some more memory
+	constexpr double blocking_overhead = 1.2;
+	bits_per_url *= blocking_overhead;
+
+	auto num_blocks = std::ceil(double(expected_num_urls) * bits_per_url / double(block_bits));
+
+	// block index is computed from 32 bits of the hash
+	if (num_blocks > double(std::numeric_limits<uint32_t>::max())) {
+		throw std::invalid_argument("urlmodel: seen_set: too many expected URLs");
+	}
+
+	this->num_blocks = std::max(uint64_t(num_blocks), uint64_t(1));
+
+	// first block holds the header
+	this->buffer = std::make_unique<block[]>(this->num_blocks + 1);
+
+	header h{};
+	h.magic = magic;
+	h.version = format_version;
+	h.num_hashes = this->num_hashes;
+	h.num_blocks = this->num_blocks;
+	std::memcpy(this->buffer.get(), &h, sizeof(h));
+
+	this->blocks = std::next(this->buffer.get());
+}
+
+seen_set::seen_set(utki::span<uint8_t> data)
+{
+	static_assert(sizeof(header) <= sizeof(block));
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+	if (reinterpret_cast<uintptr_t>(data.data()) % alignof(block) != 0) {
+		throw std::invalid_argument("urlmodel: seen_set: data is not aligned to 64 bytes");
+	}
+
+	if (data.size() < sizeof(block) || data.size() % sizeof(block) != 0) {
+		throw std::invalid_argument("urlmodel: seen_set: invalid data size");
+	}
+
+	header h{};
+	std::memcpy(&h, data.data(), sizeof(h));
+
+	if (h.magic != magic) {
+		throw std::invalid_argument("urlmodel: seen_set: data is not a seen_set");
+	}
+
+	if (h.version != format_version) {
+		throw std::invalid_argument("urlmodel: seen_set: unsupported data format version");
+	}
+
+	if (h.num_hashes == 0 || h.num_hashes > max_num_hashes) {
+		throw std::invalid_argument("urlmodel: seen_set: invalid number of hashes");
+	}
+
+	if (h.num_blocks == 0 || h.num_blocks > std::numeric_limits<uint32_t>::max()
+		|| h.num_blocks != data.size() / sizeof(block) - 1)
+	{
+		throw std::invalid_argument("urlmodel: seen_set: invalid number of blocks");
+	}
+
+	this->num_hashes = h.num_hashes;
+	this->num_blocks = h.num_blocks;
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+	this->blocks = std::next(reinterpret_cast<block*>(data.data()));
+}
+
+seen_set::seen_set(seen_set&& s) noexcept :
+	buffer(std::move(s.buffer)),
+	blocks(std::exchange(s.blocks, nullptr)),
+	num_blocks(std::exchange(s.num_blocks, 0)),
+	num_hashes(std::exchange(s.num_hashes, 0))
+{}
+
+seen_set& seen_set::operator=(seen_set&& s) noexcept
+{
+	if (this != &s) {
+		this->buffer = std::move(s.buffer);
+		this->blocks = std::exchange(s.blocks, nullptr);
+		this->num_blocks = std::exchange(s.num_blocks, 0);
+		this->num_hashes = std::exchange(s.num_hashes, 0);
+	}
+	return *this;
+}
+
+const seen_set::block& seen_set::get_block(uint64_t hash) const noexcept
+{
+	ASSERT(this->blocks)
+
+	// multiply-shift maps 32 bits of the hash to [0, num_blocks) range without division
+	return this->blocks[((hash >> 32) * this->num_blocks) >> 32];
+}
+
+bool seen_set::insert(uint64_t hash) noexcept
+{
+	auto& b = this->get_block(hash);
+
+	static_assert(block_bits == 512, "bit_generator generates 9-bit positions");
+
+	bit_generator gen(hash);
+
+	bool inserted = false;
+	for (uint32_t i = 0; i != this->num_hashes; ++i) {
+		auto bit = gen.next();
+		auto mask = uint64_t(1) << (bit % 64);
+		auto& w = b.words[bit / 64];
+		if (!(w & mask)) {
+			inserted = true;
+			w |= mask;
+		}
+	}
+
+	return inserted;
+}
+
+bool seen_set::contains(uint64_t hash) const noexcept
+{
+	const auto& b = this->get_block(hash);
+
+	bit_generator gen(hash);
+
+	for (uint32_t i = 0; i != this->num_hashes; ++i) {
+		auto bit = gen.next();
+		if (!(b.words[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool seen_set::insert(const urlmodel::url& url) noexcept
+{
+	return this->insert(hash_url(url));
+}
+
+bool seen_set::contains(const urlmodel::url& url) const noexcept
+{
+	return this->contains(hash_url(url));
+}
+
+void seen_set::insert(utki::span<const urlmodel::url> urls) noexcept
+{
+	std::array<uint64_t, batch_size> hashes{};
+
+	for (size_t i = 0; i < urls.size(); i += batch_size) {
+		auto n = std::min(batch_size, urls.size() - i);
+
+		// hash the whole batch and prefetch the blocks, so that memory loads overlap
+		for (size_t j = 0; j != n; ++j) {
+			hashes[j] = hash_url(urls[i + j]);
+			prefetch(&this->get_block(hashes[j]));
+		}
+
+		for (size_t j = 0; j != n; ++j) {
+			this->insert(hashes[j]);
+		}
+	}
+}
+
+void seen_set::contains(utki::span<const urlmodel::url> urls, utki::span<bool> results) const noexcept
+{
+	ASSERT(urls.size() == results.size())
+
+	std::array<uint64_t, batch_size> hashes{};
+
+	for (size_t i = 0; i < urls.size(); i += batch_size) {
+		auto n = std::min(batch_size, urls.size() - i);
+
+		for (size_t j = 0; j != n; ++j) {
+			hashes[j] = hash_url(urls[i + j]);
+			prefetch(&this->get_block(hashes[j]));
+		}
+
+		for (size_t j = 0; j != n; ++j) {
+			results[i + j] = this->contains(hashes[j]);
+		}
+	}
+}
+
+utki::span<const uint8_t> seen_set::get_data() const noexcept
+{
+	if (!this->blocks) {
+		return {};
+	}
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+	return {reinterpret_cast<const uint8_t*>(std::prev(this->blocks)), size_t(this->num_blocks + 1) * sizeof(block)};
+}
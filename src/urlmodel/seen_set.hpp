@@ -0,0 +1,181 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include <utki/span.hpp>
+
+#include "url.hpp"
+
+namespace urlmodel {
+
+/**
+ * @brief Probabilistic set of seen URLs.
+ * Memory-compact set of URLs, e.g. for deduplication of URLs in web crawlers.
+ * Only the URL hashes are stored, see urlmodel::hash_url(), in a blocked Bloom filter.
+ * The set can tell that a URL has been seen while it actually has not (false positive),
+ * with configured probability, but never tells that a seen URL has not been seen.
+ * Each URL sets bits in a single 64 bytes block of the filter, so checking a URL touches
+ * a single cache line.
+ *
+ * The filter memory has the same layout as in a file, see get_data(), so the set can be saved to a file
+ * and later used right from the memory mapped file, without reading and rebuilding it.
+ * The set is not thread-safe, i.e. it cannot be modified from several threads concurrently.
+ */
+class seen_set
+{
+	// single cache line
+	struct alignas(64) block {
+		std::array<uint64_t, 8> words;
+	};
+
+	constexpr static size_t block_bits = sizeof(block) * 8;
+
+	constexpr static uint32_t max_num_hashes = 16;
+
+	// memory owned by the set in case it is not constructed on external memory, first block holds the header
+	std::unique_ptr<block[]> buffer;
+
+	// first block after the header
+	block* blocks = nullptr;
+
+	uint64_t num_blocks = 0;
+	uint32_t num_hashes = 0;
+
+	const block& get_block(uint64_t hash) const noexcept;
+	block& get_block(uint64_t hash) noexcept
+	{
+		return const_cast<block&>(const_cast<const seen_set*>(this)->get_block(hash));
+	}
+
+public:
+	/**
+   * @brief Constructor.
+   * Creates an empty set.
+   * @param expected_num_urls - number of URLs expected to be inserted to the set.
+   * @param false_positive_rate - desired probability of false positive in case the expected number of URLs
+   *     is inserted. Must be in (0, 1) range.
+   * @throw std::invalid_argument in case the parameters are out of range.
+   */
+	seen_set(uint64_t expected_num_urls, double false_positive_rate);
+
+	/**
+   * @brief Construct on external memory.
+   * The set uses the given memory as is, without copying it. Typically, the memory is a memory mapped file
+   * previously written with the data returned by get_data(). In case the memory is mapped for writing,
+   * the URLs inserted to the set go right to the file.
+   * @param data - memory with the set data. Must be 64 bytes aligned and outlive the set.
+   * @throw std::invalid_argument in case the data is not a valid set data or is not aligned.
+   */
+	explicit seen_set(utki::span<uint8_t> data);
+
+	seen_set(const seen_set&) = delete;
+	seen_set& operator=(const seen_set&) = delete;
+
+	/**
+   * @brief Move constructor.
+   * The moved-from set is left empty, it can only be destroyed or assigned to.
+   */
+	seen_set(seen_set&& s) noexcept;
+
+	/**
+   * @brief Move assignment.
+   * The moved-from set is left empty, it can only be destroyed or assigned to.
+   */
+	seen_set& operator=(seen_set&& s) noexcept;
+
+	~seen_set() = default;
+
+	/**
+   * @brief Insert URL hash.
+   * @param hash - URL hash, see urlmodel::hash_url().
+   * @return true in case the hash was not in the set.
+   * @return false in case the hash was probably in the set already.
+   */
+	bool insert(uint64_t hash) noexcept;
+
+	/**
+   * @brief Insert URL.
+   * @param url - URL to insert.
+   * @return true in case the URL was not in the set.
+   * @return false in case the URL was probably in the set already.
+   */
+	bool insert(const urlmodel::url& url) noexcept;
+
+	/**
+   * @brief Insert URLs.
+   * Faster than inserting the URLs one by one, because memory of the filter is prefetched in advance.
+   * @param urls - URLs to insert.
+   */
+	void insert(utki::span<const urlmodel::url> urls) noexcept;
+
+	/**
+   * @brief Check if URL hash is in the set.
+   * @param hash - URL hash, see urlmodel::hash_url().
+   * @return true in case the hash is probably in the set.
+   * @return false in case the hash is definitely not in the set.
+   */
+	bool contains(uint64_t hash) const noexcept;
+
+	/**
+   * @brief Check if URL is in the set.
+   * @param url - URL to check.
+   * @return true in case the URL is probably in the set.
+   * @return false in case the URL is definitely not in the set.
+   */
+	bool contains(const urlmodel::url& url) const noexcept;
+
+	/**
+   * @brief Check if URLs are in the set.
+   * Faster than checking the URLs one by one, because memory of the filter is prefetched in advance.
+   * @param urls - URLs to check.
+   * @param results - results of the check, one for each URL. Must be of the same size as urls.
+   */
+	void contains(utki::span<const urlmodel::url> urls, utki::span<bool> results) const noexcept;
+
+	/**
+   * @brief Get set data.
+   * The data can be saved to a file and later used to construct the set on the memory mapped file.
+   * @return memory of the set, including the header.
+   * @return empty span in case the set was moved from.
+   */
+	utki::span<const uint8_t> get_data() const noexcept;
+
+	/**
+   * @brief Get number of hash functions.
+   * @return number of bits set in the filter for each URL.
+   */
+	uint32_t get_num_hashes() const noexcept
+	{
+		return this->num_hashes;
+	}
+};
+
+} // namespace urlmodel
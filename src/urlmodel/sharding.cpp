@@ -0,0 +1,135 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "sharding.hpp"
+
+#include <stdexcept>
+
+#include <utki/debug.hpp>
+
+#include "mix.hpp"
+#include "parallel.hpp"
+#include "url_hash.hpp"
+
+using namespace urlmodel;
+
+namespace {
+// inputs smaller than this are partitioned in a single thread
+constexpr size_t min_parallel_size = 1 << 14;
+} // namespace
+
+uint32_t urlmodel::jump_consistent_hash(uint64_t key, uint32_t num_buckets) noexcept
+{
+	ASSERT(num_buckets > 0)
+
+	int64_t b = -1;
+	int64_t j = 0;
+	while (j < int64_t(num_buckets)) {
+		b = j;
+		key = key * 2862933555777941757 + 1;
+		j = int64_t(double(b + 1) * (double(int64_t(1) << 31) / double((key >> 33) + 1)));
+	}
+	return uint32_t(b);
+}
+
+utki::span<const size_t> sharder::buckets::operator[](uint32_t shard) const noexcept
+{
+	ASSERT(shard < this->size())
+
+	auto begin = this->offsets[shard];
+	return utki::make_span(this->indices).subspan(begin, this->offsets[shard + 1] - begin);
+}
+
+sharder::sharder(uint32_t num_shards, bool use_port) :
+	num_shards(num_shards),
+	use_port(use_port)
+{
+	if (num_shards == 0) {
+		throw std::invalid_argument("urlmodel: sharder: number of shards must be greater than zero");
+	}
+}
+
+uint64_t sharder::get_key(std::string_view scheme, std::string_view host, uint16_t port) const noexcept
+{
+	auto key = hash_host(host);
+
+	if (!this->use_port) {
+		return key;
+	}
+
+	if (port == get_default_port(scheme)) {
+		port = 0;
+	}
+
+	return detail::mix(key ^ (uint64_t(port) + 0x9e3779b97f4a7c15));
+}
+
+sharder::buckets sharder::partition(utki::span<const urlmodel::url> urls, unsigned num_threads) const
+{
+	size_t num_chunks = urls.size() < min_parallel_size ? 1 : detail::get_num_threads(num_threads);
+
+	std::vector<uint32_t> shards(urls.size());
+
+	// number of URLs of each chunk assigned to each shard, chunk after chunk
+	std::vector<size_t> counts(num_chunks * this->num_shards);
+
+	detail::parallel_for_chunks(urls.size(), num_chunks, [&](size_t chunk, size_t begin, size_t end) {
+		auto chunk_counts = std::next(counts.begin(), ptrdiff_t(chunk * this->num_shards));
+		for (size_t i = begin; i != end; ++i) {
+			auto s = this->get_shard(urls[i]);
+			shards[i] = s;
+			++chunk_counts[s];
+		}
+	});
+
+	buckets ret;
+	ret.offsets.resize(size_t(this->num_shards) + 1);
+
+	// turn the counts into positions where each chunk writes its indices of each shard,
+	// chunks go in order within a shard, so each bucket ends up in ascending order
+	size_t offset = 0;
+	for (size_t s = 0; s != this->num_shards; ++s) {
+		ret.offsets[s] = offset;
+		for (size_t chunk = 0; chunk != num_chunks; ++chunk) {
+			auto& c = counts[chunk * this->num_shards + s];
+			auto n = c;
+			c = offset;
+			offset += n;
+		}
+	}
+	ret.offsets.back() = offset;
+
+	ret.indices.resize(urls.size());
+
+	detail::parallel_for_chunks(urls.size(), num_chunks, [&](size_t chunk, size_t begin, size_t end) {
+		auto positions = std::next(counts.begin(), ptrdiff_t(chunk * this->num_shards));
+		for (size_t i = begin; i != end; ++i) {
+			ret.indices[positions[shards[i]]++] = i;
+		}
+	});
+
+	return ret;
+}
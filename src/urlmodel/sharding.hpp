@@ -0,0 +1,161 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <utki/span.hpp>
+
+#include "url.hpp"
+
+namespace urlmodel {
+
+/**
+ * @brief Jump consistent hash.
+ * Maps a key to one of the buckets, see "A Fast, Minimal Memory, Consistent Hash Algorithm" by John Lamping
+ * and Eric Veach. When the number of buckets grows from n to n + 1, only 1 / (n + 1) of the keys move,
+ * and all of them move to the new bucket.
+ * @param key - key to map, should be a well distributed hash value.
+ * @param num_buckets - number of buckets, must be greater than zero.
+ * @return bucket number in [0, num_buckets) range.
+ */
+uint32_t jump_consistent_hash(uint64_t key, uint32_t num_buckets) noexcept;
+
+/**
+ * @brief Host-based URL sharding.
+ * Assigns URLs to shards by host, so that all URLs of the same host, and optionally port,
+ * go to the same shard, e.g. to keep per-host politeness state and connection pools local to a worker.
+ * The shard is chosen with jump consistent hash of the stable host hash, see urlmodel::hash_host(),
+ * so the assignment is the same between program runs and on different nodes, and when the number of shards
+ * changes, only a minimal fraction of hosts moves to other shards.
+ */
+class sharder
+{
+	uint32_t num_shards;
+	bool use_port;
+
+public:
+	/**
+   * @brief Result of partitioning URLs to shards.
+   * Holds indices of the URLs in the partitioned collection, grouped by shard.
+   */
+	class buckets
+	{
+		friend class sharder;
+
+		// URL indices of all buckets, bucket after bucket
+		std::vector<size_t> indices;
+
+		// offsets[i] is start of bucket i in the indices, one extra element holds the end of the last bucket
+		std::vector<size_t> offsets;
+
+	public:
+		/**
+	   * @brief Get number of buckets.
+	   * @return number of shards.
+	   */
+		uint32_t size() const noexcept
+		{
+			return uint32_t(this->offsets.size() - 1);
+		}
+
+		/**
+	   * @brief Get bucket of the shard.
+	   * @param shard - shard number, must be less than size().
+	   * @return indices of the URLs assigned to the shard, in ascending order.
+	   */
+		utki::span<const size_t> operator[](uint32_t shard) const noexcept;
+	};
+
+	/**
+   * @brief Constructor.
+   * @param num_shards - number of shards, must be greater than zero.
+   * @param use_port - whether the port is part of the sharding key. In case true, URLs of the same host,
+   *     but with different ports, may go to different shards. The default port of the scheme is same as no port.
+   * @throw std::invalid_argument in case the number of shards is zero.
+   */
+	explicit sharder(uint32_t num_shards, bool use_port = false);
+
+	uint32_t get_num_shards() const noexcept
+	{
+		return this->num_shards;
+	}
+
+	/**
+   * @brief Get sharding key.
+   * Allows sharding URLs which are not in form of urlmodel::url object, e.g. compact_url.
+   * @param scheme - URL scheme, used to determine the default port.
+   * @param host - URL host, case-insensitive.
+   * @param port - URL port, 0 means no port.
+   * @return stable sharding key.
+   */
+	uint64_t get_key(std::string_view scheme, std::string_view host, uint16_t port) const noexcept;
+
+	/**
+   * @brief Get sharding key of URL.
+   * @param url - URL to get the key of.
+   * @return stable sharding key.
+   */
+	uint64_t get_key(const urlmodel::url& url) const noexcept
+	{
+		return this->get_key(url.scheme, url.host, url.port);
+	}
+
+	/**
+   * @brief Get shard by sharding key.
+   * @param key - sharding key, see get_key().
+   * @return shard number in [0, get_num_shards()) range.
+   */
+	uint32_t get_shard(uint64_t key) const noexcept
+	{
+		return jump_consistent_hash(key, this->num_shards);
+	}
+
+	/**
+   * @brief Get shard of URL.
+   * @param url - URL to get the shard of.
+   * @return shard number in [0, get_num_shards()) range.
+   */
+	uint32_t get_shard(const urlmodel::url& url) const noexcept
+	{
+		return this->get_shard(this->get_key(url));
+	}
+
+	/**
+   * @brief Partition URLs to shards.
+   * The URLs are not moved, only their indices are grouped by shard.
+   * @param urls - URLs to partition.
+   * @param num_threads - number of threads to use, 0 means number of hardware threads.
+   *     Small inputs are partitioned in a single thread regardless of this value.
+   * @return URL indices grouped by shard.
+   */
+	buckets partition(utki::span<const urlmodel::url> urls, unsigned num_threads = 0) const;
+};
+
+} // namespace urlmodel
@@ -0,0 +1,474 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "sort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include "parallel.hpp"
+
+using namespace urlmodel;
+
+namespace {
+// ranges smaller than this are sorted with insertion sort
+constexpr size_t insertion_sort_threshold = 32;
+
+// inputs smaller than this are sorted in a single thread
+constexpr size_t min_parallel_size = 1 << 14;
+
+// ranges smaller than this are not split among threads
+constexpr size_t min_grain_size = 1 << 12;
+
+// key end, and one bucket per key byte value
+constexpr size_t num_buckets = 1 + 0x100;
+
+// calls func(begin, end) for consecutive chunks of [0, size) range in parallel
+template <typename func_type>
+void parallel_for(size_t size, unsigned num_threads, func_type func)
+{
+	if (num_threads <= 1 || size < min_parallel_size) {
+		func(size_t(0), size);
+		return;
+	}
+
+	detail::parallel_for_chunks(size, num_threads, [&func](size_t /* chunk */, size_t begin, size_t end) {
+		func(begin, end);
+	});
+}
+
+// The sort key of a URL is its host followed by its path segments. To make the byte-wise order of the keys
+// the same as the order of the components themselves, each component is terminated by 0x00 byte and
+// the bytes 0x00 and 0x01 within the component are escaped as 0x01 0x01 and 0x01 0x02 respectively.
+// So, a key which is a prefix of another key, e.g. a shorter path, goes first.
+
+size_t get_escaped_size(std::string_view str) noexcept
+{
+	return str.size() + size_t(std::count_if(str.begin(), str.end(), [](char c) {
+			   return uint8_t(c) <= 1;
+		   })) +
+		1;
+}
+
+char* write_escaped(char* dst, std::string_view str) noexcept
+{
+	for (auto c : str) {
+		if (uint8_t(c) <= 1) {
+			*dst = char(1);
+			++dst;
+			*dst = char(uint8_t(c) + 1);
+		} else {
+			*dst = c;
+		}
+		++dst;
+	}
+	*dst = char(0);
+	++dst;
+	return dst;
+}
+
+size_t get_key_size(const std::vector<std::string>& path) noexcept
+{
+	size_t ret = 0;
+	for (const auto& s : path) {
+		ret += get_escaped_size(s);
+	}
+	return ret;
+}
+
+char* write_key(char* dst, const std::vector<std::string>& path) noexcept
+{
+	for (const auto& s : path) {
+		dst = write_escaped(dst, s);
+	}
+	return dst;
+}
+
+size_t get_key_size(const urlmodel::url& url) noexcept
+{
+	return get_escaped_size(url.host) + get_key_size(url.path);
+}
+
+char* write_key(char* dst, const urlmodel::url& url) noexcept
+{
+	dst = write_escaped(dst, url.host);
+	return write_key(dst, url.path);
+}
+
+struct range {
+	size_t begin;
+	size_t end;
+
+	// position in the keys to sort by
+	size_t depth;
+
+	size_t size() const noexcept
+	{
+		return this->end - this->begin;
+	}
+};
+
+class radix_sorter
+{
+	std::vector<char> keys;
+
+	// key of i-th element is at [offsets[i], offsets[i + 1])
+	std::vector<size_t> offsets;
+
+	std::vector<size_t> tmp;
+
+	size_t grain_size = 0;
+
+	// parallel sorting task queue
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::vector<range> queue;
+
+	// number of tasks queued or being processed
+	size_t num_pending = 0;
+
+	std::string_view get_key(size_t element) const noexcept
+	{
+		return std::string_view(
+			std::next(this->keys.data(), ptrdiff_t(this->offsets[element])),
+			this->offsets[element + 1] - this->offsets[element]
+		);
+	}
+
+	size_t get_bucket(size_t element, size_t depth) const noexcept
+	{
+		auto pos = this->offsets[element] + depth;
+		if (pos >= this->offsets[element + 1]) {
+			return 0;
+		}
+		return 1 + size_t(uint8_t(this->keys[pos]));
+	}
+
+	void insertion_sort(const range& r) noexcept
+	{
+		for (size_t i = r.begin + 1; i < r.end; ++i) {
+			auto element = this->index[i];
+			auto key = this->get_key(element).substr(r.depth);
+
+			auto j = i;
+			for (; j != r.begin && key < this->get_key(this->index[j - 1]).substr(r.depth); --j) {
+				this->index[j] = this->index[j - 1];
+			}
+			this->index[j] = element;
+		}
+	}
+
+	// Makes one counting sort pass over the range and calls push() for each resulting bucket which needs
+	// further sorting.
+	template <typename push_type>
+	void distribute(range r, push_type push)
+	{
+		std::array<size_t, num_buckets> counts{};
+
+		for (;;) {
+			counts.fill(0);
+			for (size_t i = r.begin; i != r.end; ++i) {
+				++counts[this->get_bucket(this->index[i], r.depth)];
+			}
+
+			auto b = this->get_bucket(this->index[r.begin], r.depth);
+			if (counts[b] != r.size()) {
+				break;
+			}
+
+			// all keys have the same byte at this depth, no need to move anything
+			if (b == 0) {
+				// all keys are equal
+				return;
+			}
+			++r.depth;
+		}
+
+		std::array<size_t, num_buckets> positions{};
+		std::exclusive_scan(counts.begin(), counts.end(), positions.begin(), r.begin);
+
+		for (size_t i = r.begin; i != r.end; ++i) {
+			auto element = this->index[i];
+			auto& pos = positions[this->get_bucket(element, r.depth)];
+			this->tmp[pos] = element;
+			++pos;
+		}
+
+		std::copy(
+			std::next(this->tmp.begin(), ptrdiff_t(r.begin)),
+			std::next(this->tmp.begin(), ptrdiff_t(r.end)),
+			std::next(this->index.begin(), ptrdiff_t(r.begin))
+		);
+
+		// keys in bucket 0 are ended, so they are all equal
+		auto begin = r.begin + counts[0];
+		for (size_t b = 1; b != num_buckets; ++b) {
+			auto end = begin + counts[b];
+			if (counts[b] > 1) {
+				push(range{begin, end, r.depth + 1});
+			}
+			begin = end;
+		}
+	}
+
+	void sort_sequentially(const range& r)
+	{
+		// use explicit stack, because recursion depth can be as big as key size
+		std::vector<range> stack = {r};
+
+		while (!stack.empty()) {
+			auto t = stack.back();
+			stack.pop_back();
+
+			if (t.size() <= insertion_sort_threshold) {
+				this->insertion_sort(t);
+				continue;
+			}
+
+			this->distribute(t, [&stack](const range& s) {
+				stack.push_back(s);
+			});
+		}
+	}
+
+	void push_task(const range& r)
+	{
+		{
+			std::lock_guard lock(this->mutex);
+			++this->num_pending;
+			this->queue.push_back(r);
+		}
+		this->cond.notify_one();
+	}
+
+	void work()
+	{
+		for (;;) {
+			range r{};
+			{
+				std::unique_lock lock(this->mutex);
+				this->cond.wait(lock, [this]() {
+					return !this->queue.empty() || this->num_pending == 0;
+				});
+
+				if (this->queue.empty()) {
+					// all done
+					return;
+				}
+
+				r = this->queue.back();
+				this->queue.pop_back();
+			}
+
+			if (r.size() <= this->grain_size) {
+				this->sort_sequentially(r);
+			} else {
+				this->distribute(r, [this](const range& s) {
+					this->push_task(s);
+				});
+			}
+
+			bool is_done = false;
+			{
+				std::lock_guard lock(this->mutex);
+				--this->num_pending;
+				is_done = this->num_pending == 0;
+			}
+			if (is_done) {
+				this->cond.notify_all();
+			}
+		}
+	}
+
+public:
+	// sorted element indices
+	std::vector<size_t> index;
+
+	template <typename element_type>
+	radix_sorter(utki::span<const element_type> elements, unsigned num_threads) :
+		offsets(elements.size() + 1),
+		tmp(elements.size()),
+		index(elements.size())
+	{
+		parallel_for(elements.size(), num_threads, [this, &elements](size_t begin, size_t end) {
+			for (size_t i = begin; i != end; ++i) {
+				this->offsets[i + 1] = get_key_size(elements[i]);
+			}
+		});
+
+		std::partial_sum(this->offsets.begin(), this->offsets.end(), this->offsets.begin());
+
+		this->keys.resize(this->offsets.back());
+
+		parallel_for(elements.size(), num_threads, [this, &elements](size_t begin, size_t end) {
+			for (size_t i = begin; i != end; ++i) {
+				write_key(std::next(this->keys.data(), ptrdiff_t(this->offsets[i])), elements[i]);
+				this->index[i] = i;
+			}
+		});
+	}
+
+	void sort(unsigned num_threads)
+	{
+		range all{0, this->index.size(), 0};
+
+		if (num_threads <= 1 || all.size() < min_parallel_size) {
+			this->sort_sequentially(all);
+			return;
+		}
+
+		// split the work into more tasks than threads, so that the threads are evenly loaded
+		constexpr size_t tasks_per_thread = 16;
+		this->grain_size = std::max(all.size() / (num_threads * tasks_per_thread), min_grain_size);
+
+		this->push_task(all);
+
+		std::vector<std::thread> threads;
+		threads.reserve(num_threads - 1);
+		try {
+			for (unsigned i = 1; i != num_threads; ++i) {
+				threads.emplace_back([this]() {
+					this->work();
+				});
+			}
+		} catch (std::system_error&) {
+			// could not start more threads, continue with the ones started
+		}
+
+		this->work();
+
+		for (auto& t : threads) {
+			t.join();
+		}
+	}
+};
+
+// places elements in the order given by the index, the index is destroyed
+template <typename element_type>
+void apply_permutation(utki::span<element_type> elements, std::vector<size_t>& index)
+{
+	for (size_t i = 0; i != elements.size(); ++i) {
+		if (index[i] == i) {
+			continue;
+		}
+
+		// move elements along the permutation cycle
+		auto e = std::move(elements[i]);
+		auto j = i;
+		for (;;) {
+			auto k = index[j];
+			index[j] = j;
+			if (k == i) {
+				elements[j] = std::move(e);
+				break;
+			}
+			elements[j] = std::move(elements[k]);
+			j = k;
+		}
+	}
+}
+
+template <typename element_type>
+void radix_sort(utki::span<element_type> elements, unsigned num_threads)
+{
+	if (elements.size() <= 1) {
+		return;
+	}
+
+	num_threads = detail::get_num_threads(num_threads);
+
+	radix_sorter sorter(utki::span<const element_type>(elements), num_threads);
+
+	sorter.sort(num_threads);
+
+	apply_permutation(elements, sorter.index);
+}
+
+bool is_same_prefix(
+	const std::vector<std::string>& a,
+	const std::vector<std::string>& b,
+	size_t prefix_size
+) noexcept
+{
+	auto a_size = std::min(a.size(), prefix_size);
+	auto b_size = std::min(b.size(), prefix_size);
+
+	return a_size == b_size && std::equal(a.begin(), std::next(a.begin(), ptrdiff_t(a_size)), b.begin());
+}
+
+bool is_same_prefix(const urlmodel::url& a, const urlmodel::url& b, size_t prefix_size) noexcept
+{
+	return a.host == b.host && is_same_prefix(a.path, b.path, prefix_size);
+}
+
+template <typename element_type>
+std::vector<utki::span<const element_type>> group(utki::span<const element_type> elements, size_t prefix_size)
+{
+	std::vector<utki::span<const element_type>> ret;
+
+	size_t begin = 0;
+	for (size_t i = 1; i <= elements.size(); ++i) {
+		if (i == elements.size() || !is_same_prefix(elements[begin], elements[i], prefix_size)) {
+			ret.push_back(elements.subspan(begin, i - begin));
+			begin = i;
+		}
+	}
+
+	return ret;
+}
+} // namespace
+
+void urlmodel::sort_by_host_and_path(utki::span<urlmodel::url> urls, unsigned num_threads)
+{
+	radix_sort(urls, num_threads);
+}
+
+void urlmodel::sort_paths(utki::span<std::vector<std::string>> paths, unsigned num_threads)
+{
+	radix_sort(paths, num_threads);
+}
+
+std::vector<utki::span<const urlmodel::url>> urlmodel::group_by_path_prefix(
+	utki::span<const urlmodel::url> urls,
+	size_t prefix_size
+)
+{
+	return group(urls, prefix_size);
+}
+
+std::vector<utki::span<const std::vector<std::string>>> urlmodel::group_by_path_prefix(
+	utki::span<const std::vector<std::string>> paths,
+	size_t prefix_size
+)
+{
+	return group(paths, prefix_size);
+}
@@ -0,0 +1,89 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <utki/span.hpp>
+
+#include "url.hpp"
+
+namespace urlmodel {
+
+/**
+ * @brief Sort URLs by host and path.
+ * URLs are ordered by host, URLs with the same host are ordered by path in the same way as path_less does.
+ * Other URL components do not affect the order. The sort is stable, i.e. the URLs with the same host and path
+ * keep their relative order.
+ * The sort is a parallel MSD radix sort over the host and path segment bytes, so it does not compare
+ * the strings over and over again as comparison sort does.
+ * @param urls - URLs to sort.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ *     Small inputs are sorted in a single thread regardless of this value.
+ */
+void sort_by_host_and_path(utki::span<urlmodel::url> urls, unsigned num_threads = 0);
+
+/**
+ * @brief Sort paths.
+ * Paths are ordered in the same way as path_less does. The sort is stable.
+ * @param paths - paths to sort.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ *     Small inputs are sorted in a single thread regardless of this value.
+ */
+void sort_paths(utki::span<std::vector<std::string>> paths, unsigned num_threads = 0);
+
+/**
+ * @brief Group sorted URLs by host and path prefix.
+ * A group is a run of consecutive URLs which have the same host and the same first prefix_size path segments.
+ * URLs with shorter paths are grouped by their whole path.
+ * In case the URLs are sorted with sort_by_host_and_path(), each such host and path prefix forms
+ * exactly one group.
+ * @param urls - URLs to group.
+ * @param prefix_size - number of path segments in the prefix.
+ * @return groups in the same order as they appear in the input.
+ */
+std::vector<utki::span<const urlmodel::url>> group_by_path_prefix(
+	utki::span<const urlmodel::url> urls,
+	size_t prefix_size
+);
+
+/**
+ * @brief Group sorted paths by path prefix.
+ * A group is a run of consecutive paths which have the same first prefix_size segments.
+ * Paths shorter than that are grouped by the whole path.
+ * In case the paths are sorted with sort_paths(), each such prefix forms exactly one group.
+ * @param paths - paths to group.
+ * @param prefix_size - number of path segments in the prefix.
+ * @return groups in the same order as they appear in the input.
+ */
+std::vector<utki::span<const std::vector<std::string>>> group_by_path_prefix(
+	utki::span<const std::vector<std::string>> paths,
+	size_t prefix_size
+);
+
+} // namespace urlmodel
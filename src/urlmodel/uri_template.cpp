@@ -0,0 +1,500 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "uri_template.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "parser.hpp"
+
+using namespace urlmodel;
+
+namespace {
+struct operator_info {
+	std::string_view first;
+	std::string_view separator;
+	bool named;
+	std::string_view if_empty;
+	bool allow_reserved;
+};
+
+// see RFC 6570 appendix A
+const operator_info& get_operator_info(char op) noexcept
+{
+	static const operator_info simple = {"", ",", false, "", false};
+	static const operator_info reserved = {"", ",", false, "", true};
+	static const operator_info fragment = {"#", ",", false, "", true};
+	static const operator_info label = {".", ".", false, "", false};
+	static const operator_info path_segment = {"/", "/", false, "", false};
+	static const operator_info path_parameter = {";", ";", true, "", false};
+	static const operator_info query = {"?", "&", true, "=", false};
+	static const operator_info query_continuation = {"&", "&", true, "=", false};
+
+	switch (op) {
+		case '+':
+			return reserved;
+		case '#':
+			return fragment;
+		case '.':
+			return label;
+		case '/':
+			return path_segment;
+		case ';':
+			return path_parameter;
+		case '?':
+			return query;
+		case '&':
+			return query_continuation;
+		default:
+			return simple;
+	}
+}
+
+bool is_unreserved(char c) noexcept
+{
+	return detail::is_alpha(c) || detail::is_digit(c) || c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+bool is_reserved(char c) noexcept
+{
+	return std::string_view(":/?#[]@!$&'()*+,;=").find(c) != std::string_view::npos;
+}
+
+bool is_allowed(char c, bool allow_reserved) noexcept
+{
+	return is_unreserved(c) || (allow_reserved && is_reserved(c));
+}
+
+bool is_pct_encoded(std::string_view str, size_t i) noexcept
+{
+	return str[i] == '%' && i + 2 < str.size() && detail::is_hex_digit(str[i + 1]) &&
+		detail::is_hex_digit(str[i + 2]);
+}
+
+bool needs_encoding(std::string_view str, bool allow_reserved) noexcept
+{
+	for (size_t i = 0; i != str.size(); ++i) {
+		if (!is_allowed(str[i], allow_reserved) && !(allow_reserved && is_pct_encoded(str, i))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Percent-encodes characters which are not allowed.
+// In case reserved characters are allowed, percent-encoded triplets are kept as is.
+void encode(std::string_view str, bool allow_reserved, std::string& out)
+{
+	constexpr std::string_view hex_digits = "0123456789ABCDEF";
+
+	for (size_t i = 0; i != str.size(); ++i) {
+		auto c = str[i];
+		if (is_allowed(c, allow_reserved)) {
+			out.push_back(c);
+		} else if (allow_reserved && is_pct_encoded(str, i)) {
+			out.append(str.substr(i, 3));
+			i += 2;
+		} else {
+			out.push_back('%');
+			out.push_back(hex_digits[uint8_t(c) >> 4]);
+			out.push_back(hex_digits[uint8_t(c) & 0xf]);
+		}
+	}
+}
+
+// returns prefix of the string which is max_length unicode characters long
+std::string_view truncate(std::string_view str, size_t max_length) noexcept
+{
+	if (max_length == 0) {
+		return str;
+	}
+
+	size_t num_chars = 0;
+	for (size_t i = 0; i != str.size(); ++i) {
+		// skip UTF-8 continuation bytes
+		if ((uint8_t(str[i]) & 0xc0) == 0x80) {
+			continue;
+		}
+		if (num_chars == max_length) {
+			return str.substr(0, i);
+		}
+		++num_chars;
+	}
+	return str;
+}
+
+bool is_undefined(const uri_template::value& v) noexcept
+{
+	if (std::holds_alternative<std::monostate>(v)) {
+		return true;
+	}
+	if (auto l = std::get_if<uri_template::list_type>(&v)) {
+		return l->empty();
+	}
+	if (auto a = std::get_if<uri_template::associative_array_type>(&v)) {
+		return a->empty();
+	}
+	return false;
+}
+
+class string_output
+{
+	std::string& buf;
+
+public:
+	explicit string_output(std::string& buf) :
+		buf(buf)
+	{}
+
+	void literal(std::string_view str)
+	{
+		this->buf.append(str);
+	}
+
+	void value(std::string_view str, bool allow_reserved)
+	{
+		encode(str, allow_reserved, this->buf);
+	}
+};
+} // namespace
+
+class uri_template::url_output
+{
+	std::string encoded;
+
+	void feed(std::string_view str)
+	{
+		[[maybe_unused]] auto rest = this->parser.feed(utki::make_span(
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			reinterpret_cast<const uint8_t*>(str.data()),
+			str.size()
+		));
+
+		// expansion does not contain whitespace, so parser never stops in the middle of it
+		ASSERT(rest.empty())
+	}
+
+	void add_value(std::string_view str, bool allow_reserved)
+	{
+		if (allow_reserved) {
+			// the value can contain delimiters, so it has to be parsed
+			this->feed(str);
+		} else {
+			// the value is percent-encoded, so it cannot contain any delimiters and goes right to the URL component
+			this->parser.append_to_component(str);
+		}
+	}
+
+public:
+	urlmodel::parser parser;
+
+	void literal(std::string_view str)
+	{
+		if (!str.empty()) {
+			this->feed(str);
+		}
+	}
+
+	void value(std::string_view str, bool allow_reserved)
+	{
+		if (str.empty()) {
+			return;
+		}
+
+		if (!needs_encoding(str, allow_reserved)) {
+			this->add_value(str, allow_reserved);
+			return;
+		}
+
+		this->encoded.clear();
+		encode(str, allow_reserved, this->encoded);
+		this->add_value(this->encoded, allow_reserved);
+	}
+};
+
+uri_template::uri_template(std::string_view str)
+{
+	for (size_t i = 0; i != str.size();) {
+		auto c = str[i];
+
+		if (c == '{') {
+			auto end = str.find('}', i + 1);
+			if (end == std::string_view::npos) {
+				throw std::invalid_argument("urlmodel: uri_template: unterminated expression");
+			}
+
+			this->parse_expression(str.substr(i + 1, end - i - 1));
+
+			i = end + 1;
+			continue;
+		}
+
+		// literal
+
+		auto end = std::min(str.find('{', i), str.size());
+		auto literal = str.substr(i, end - i);
+
+		for (auto lc : literal) {
+			if (lc == '}') {
+				throw std::invalid_argument("urlmodel: uri_template: unmatched '}'");
+			}
+			// control characters and space are not allowed in literals
+			if (uint8_t(lc) <= ' ' || lc == 0x7f) {
+				throw std::invalid_argument("urlmodel: uri_template: forbidden character in literal");
+			}
+		}
+
+		auto offset = this->literals.size();
+
+		// characters which are not allowed in URI are percent-encoded, see RFC 6570 section 3.1
+		encode(literal, true, this->literals);
+
+		this->pieces.push_back(piece{0, uint32_t(offset), uint32_t(this->literals.size() - offset)});
+
+		i = end;
+	}
+
+	if (this->literals.size() > std::numeric_limits<uint32_t>::max()) {
+		throw std::invalid_argument("urlmodel: uri_template: template is too big");
+	}
+}
+
+void uri_template::parse_expression(std::string_view expression)
+{
+	if (expression.empty()) {
+		throw std::invalid_argument("urlmodel: uri_template: empty expression");
+	}
+
+	char op = ' ';
+	if (std::string_view("+#./;?&").find(expression.front()) != std::string_view::npos) {
+		op = expression.front();
+		expression = expression.substr(1);
+	} else if (std::string_view("=,!@|").find(expression.front()) != std::string_view::npos) {
+		throw std::invalid_argument("urlmodel: uri_template: reserved operator in expression");
+	}
+
+	auto first_varspec = this->varspecs.size();
+
+	for (;;) {
+		auto comma_pos = expression.find(',');
+		auto spec = expression.substr(0, comma_pos);
+
+		varspec vs{0, 0, false};
+
+		// modifier
+		if (!spec.empty() && spec.back() == '*') {
+			vs.explode = true;
+			spec.remove_suffix(1);
+		} else if (auto colon_pos = spec.find(':'); colon_pos != std::string_view::npos) {
+			auto length = spec.substr(colon_pos + 1);
+			spec = spec.substr(0, colon_pos);
+
+			// max-length = %x31-39 0*3DIGIT
+			constexpr size_t max_max_length_size = 4;
+			if (length.empty() || length.size() > max_max_length_size || length.front() == '0' ||
+				!std::all_of(length.begin(), length.end(), &detail::is_digit))
+			{
+				throw std::invalid_argument("urlmodel: uri_template: malformed prefix modifier");
+			}
+
+			for (auto d : length) {
+				vs.max_length = uint16_t(vs.max_length * 10 + (d - '0'));
+			}
+		}
+
+		// varname = varchar *( ["."] varchar ), varchar = ALPHA / DIGIT / "_" / pct-encoded
+		if (spec.empty() || spec.front() == '.' || spec.back() == '.' ||
+			spec.find("..") != std::string_view::npos)
+		{
+			throw std::invalid_argument("urlmodel: uri_template: malformed variable name");
+		}
+		for (size_t j = 0; j != spec.size(); ++j) {
+			auto c = spec[j];
+			if (detail::is_alpha(c) || detail::is_digit(c) || c == '_' || c == '.') {
+				continue;
+			}
+			if (is_pct_encoded(spec, j)) {
+				j += 2;
+				continue;
+			}
+			throw std::invalid_argument("urlmodel: uri_template: malformed variable name");
+		}
+
+		auto var = std::find(this->variables.begin(), this->variables.end(), spec);
+		if (var == this->variables.end()) {
+			this->variables.emplace_back(spec);
+			var = std::prev(this->variables.end());
+		}
+		vs.variable = uint32_t(std::distance(this->variables.begin(), var));
+
+		this->varspecs.push_back(vs);
+
+		if (comma_pos == std::string_view::npos) {
+			break;
+		}
+		expression = expression.substr(comma_pos + 1);
+	}
+
+	this->pieces.push_back(
+		piece{op, uint32_t(first_varspec), uint32_t(this->varspecs.size() - first_varspec)}
+	);
+}
+
+size_t uri_template::get_variable_index(std::string_view name) const
+{
+	auto i = std::find(this->variables.begin(), this->variables.end(), name);
+	if (i == this->variables.end()) {
+		throw std::invalid_argument("urlmodel: uri_template: no such variable");
+	}
+	return size_t(std::distance(this->variables.begin(), i));
+}
+
+// see RFC 6570 appendix A
+template <typename output_type>
+void uri_template::expand(utki::span<const value> values, output_type& out) const
+{
+	for (const auto& p : this->pieces) {
+		if (p.op == 0) {
+			out.literal(std::string_view(this->literals).substr(p.offset, p.size));
+			continue;
+		}
+
+		const auto& info = get_operator_info(p.op);
+
+		bool is_first = true;
+
+		for (size_t i = p.offset; i != p.offset + p.size; ++i) {
+			const auto& vs = this->varspecs[i];
+
+			if (vs.variable >= values.size()) {
+				continue;
+			}
+
+			const auto& v = values[vs.variable];
+			if (is_undefined(v)) {
+				continue;
+			}
+
+			out.literal(is_first ? info.first : info.separator);
+			is_first = false;
+
+			std::string_view name = this->variables[vs.variable];
+
+			if (auto str = std::get_if<std::string_view>(&v)) {
+				if (info.named) {
+					out.literal(name);
+					if (str->empty()) {
+						out.literal(info.if_empty);
+						continue;
+					}
+					out.literal("=");
+				}
+				out.value(truncate(*str, vs.max_length), info.allow_reserved);
+			} else if (auto list = std::get_if<list_type>(&v)) {
+				if (!vs.explode) {
+					if (info.named) {
+						out.literal(name);
+						out.literal("=");
+					}
+					for (auto j = list->begin(); j != list->end(); ++j) {
+						if (j != list->begin()) {
+							out.literal(",");
+						}
+						out.value(*j, info.allow_reserved);
+					}
+					continue;
+				}
+
+				for (auto j = list->begin(); j != list->end(); ++j) {
+					if (j != list->begin()) {
+						out.literal(info.separator);
+					}
+					if (info.named) {
+						out.literal(name);
+						if (j->empty()) {
+							out.literal(info.if_empty);
+							continue;
+						}
+						out.literal("=");
+					}
+					out.value(*j, info.allow_reserved);
+				}
+			} else if (auto array = std::get_if<associative_array_type>(&v)) {
+				if (!vs.explode) {
+					if (info.named) {
+						out.literal(name);
+						out.literal("=");
+					}
+					for (auto j = array->begin(); j != array->end(); ++j) {
+						if (j != array->begin()) {
+							out.literal(",");
+						}
+						out.value(j->first, info.allow_reserved);
+						out.literal(",");
+						out.value(j->second, info.allow_reserved);
+					}
+					continue;
+				}
+
+				for (auto j = array->begin(); j != array->end(); ++j) {
+					if (j != array->begin()) {
+						out.literal(info.separator);
+					}
+					out.value(j->first, info.allow_reserved);
+					if (info.named && j->second.empty()) {
+						out.literal(info.if_empty);
+						continue;
+					}
+					out.literal("=");
+					out.value(j->second, info.allow_reserved);
+				}
+			}
+		}
+	}
+}
+
+void uri_template::expand(utki::span<const value> values, std::string& buf) const
+{
+	string_output out(buf);
+	this->expand(values, out);
+}
+
+std::string uri_template::expand(utki::span<const value> values) const
+{
+	std::string ret;
+	this->expand(values, ret);
+	return ret;
+}
+
+urlmodel::url uri_template::expand_url(utki::span<const value> values) const
+{
+	url_output out;
+	this->expand(values, out);
+	out.parser.end_of_data();
+	return std::move(out.parser.url);
+}
@@ -0,0 +1,165 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <utki/span.hpp>
+
+#include "url.hpp"
+
+namespace urlmodel {
+
+/**
+ * @brief URI template.
+ * URI template according to RFC 6570, level 4, i.e. all operators and value modifiers are supported.
+ * The template is compiled once into a sequence of literal and expression pieces and then can be expanded
+ * many times with different variable values, either to a string or directly to a url object without
+ * forming the intermediate string.
+ *
+ * Example:
+ * @code{.cpp}
+ * urlmodel::uri_template t("https://{host}/v1/users/{id}{?fields,limit}");
+ *
+ * std::string_view fields[] = {"name", "email"};
+ *
+ * // values are given in the order of t.get_variables(), i.e. host, id, fields, limit
+ * urlmodel::uri_template::value values[] = {
+ *     std::string_view("example.com"),
+ *     std::string_view("42"),
+ *     urlmodel::uri_template::list_type(fields)
+ * };
+ *
+ * // https://example.com/v1/users/42?fields=name,email
+ * auto url = t.expand_url(values);
+ * @endcode
+ */
+class uri_template
+{
+public:
+	using list_type = utki::span<const std::string_view>;
+	using associative_array_type = utki::span<const std::pair<std::string_view, std::string_view>>;
+
+	/**
+   * @brief Variable value.
+   * std::monostate stands for undefined variable. Empty list and empty associative array
+   * are also treated as undefined, according to RFC 6570.
+   */
+	using value = std::variant<std::monostate, std::string_view, list_type, associative_array_type>;
+
+private:
+	struct varspec {
+		// index into variables
+		uint32_t variable;
+
+		// prefix modifier, 0 means no prefix modifier
+		uint16_t max_length;
+
+		bool explode;
+	};
+
+	struct piece {
+		// 0 for literal, operator character for expression, ' ' for simple string expansion
+		char op;
+
+		// literal: offset and size in the literals pool,
+		// expression: index of the first varspec and number of varspecs
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	std::vector<piece> pieces;
+	std::vector<varspec> varspecs;
+	std::string literals;
+
+	std::vector<std::string> variables;
+
+	void parse_expression(std::string_view expression);
+
+	// expansion output which feeds the expansion to the URL parser
+	class url_output;
+
+	template <typename output_type>
+	void expand(utki::span<const value> values, output_type& out) const;
+
+public:
+	/**
+   * @brief Compile URI template.
+   * @param str - URI template string.
+   * @throw std::invalid_argument in case of malformed template.
+   */
+	explicit uri_template(std::string_view str);
+
+	/**
+   * @brief Get template variable names.
+   * @return variable names in the order of their first appearance in the template.
+   */
+	utki::span<const std::string> get_variables() const noexcept
+	{
+		return this->variables;
+	}
+
+	/**
+   * @brief Get variable index.
+   * @param name - variable name.
+   * @return index of the variable in the values array passed to expand().
+   * @throw std::invalid_argument in case there is no such variable in the template.
+   */
+	size_t get_variable_index(std::string_view name) const;
+
+	/**
+   * @brief Expand template to string.
+   * @param values - variable values, in the order of get_variables(). In case there are less values than
+   *     variables, the rest of variables are undefined.
+   * @param buf - string to append the expansion to. Its memory can be reserved in advance to avoid reallocations.
+   */
+	void expand(utki::span<const value> values, std::string& buf) const;
+
+	/**
+   * @brief Expand template to string.
+   * @param values - variable values, in the order of get_variables().
+   * @return expanded template.
+   */
+	std::string expand(utki::span<const value> values) const;
+
+	/**
+   * @brief Expand template to URL.
+   * Gives the same result as parsing the string expansion with urlmodel::parser, but without
+   * forming the string: percent-encoded variable values are added right to the URL components.
+   * @param values - variable values, in the order of get_variables().
+   * @return expanded URL.
+   * @throw std::invalid_argument in case the expansion is not a valid URL.
+   */
+	urlmodel::url expand_url(utki::span<const value> values) const;
+};
+
+} // namespace urlmodel
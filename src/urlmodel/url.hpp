@@ -26,14 +26,37 @@ SOFTWARE.
 
 #pragma once
 
+#include <array>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <utki/span.hpp>
 
 namespace urlmodel {
 
+/**
+ * @brief URL component flags.
+ * Used to select a set of URL components, e.g. component::host | component::port.
+ */
+namespace component {
+enum : uint8_t {
+	scheme = 1 << 0,
+	// username and password
+	userinfo = 1 << 1,
+	host = 1 << 2,
+	port = 1 << 3,
+	path = 1 << 4,
+	query = 1 << 5,
+	fragment = 1 << 6,
+
+	all = scheme | userinfo | host | port | path | query | fragment
+};
+} // namespace component
+
+using component_mask = uint8_t;
+
 struct path_less {
 	// allow comparing different types (heterogeneous comparison),
 	// for automatic conversion of arguments
@@ -64,6 +87,36 @@ public:
 	bool operator==(const urlmodel::url& url) const noexcept;
 
 	std::string to_string() const;
+
+	/**
+   * @brief Buffer for port number text.
+   * Big enough to hold the longest port number, i.e. "65535".
+   */
+	using port_buffer = std::array<char, 5>;
+
+	/**
+   * @brief Render port number as text.
+   * @param port - port number to render.
+   * @param port_buf - buffer to render the port number to.
+   * @return decimal text of the port number, pointing into the port buffer.
+   */
+	static std::string_view render_port(uint16_t port, port_buffer& port_buf) noexcept;
+
+	/**
+   * @brief Serialize URL as a sequence of pieces.
+   * The pieces concatenated together give the same string as to_string() does, but the pieces
+   * point straight to the URL's component strings and to static delimiter strings, so no copying is done.
+   * This is suitable for scatter-gather output, e.g. via writev().
+   * The pieces are valid until the URL object or the port buffer is modified or destroyed.
+   * @param pieces - vector to append the pieces to. It is not cleared, so it can be reused to avoid
+   *     memory allocations.
+   * @param port_buf - buffer to render the port number to.
+   */
+	void to_pieces(std::vector<utki::span<const char>>& pieces, port_buffer& port_buf) const;
 };
 
 } // namespace urlmodel
+
+#ifdef URLMODEL_HEADER_ONLY
+#	include "url_impl.hpp"
+#endif
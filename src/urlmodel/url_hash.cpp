@@ -0,0 +1,188 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "url_hash.hpp"
+
+#include <array>
+
+#include "mix.hpp"
+
+using namespace urlmodel;
+
+namespace {
+constexpr uint64_t multiplier = 0x9e3779b97f4a7c15;
+
+constexpr uint64_t ones = 0x0101010101010101;
+constexpr uint64_t high_bits = ones * 0x80;
+
+// converts ASCII upper case letters in all the 8 bytes of the word to lower case at once
+constexpr uint64_t to_lower(uint64_t w) noexcept
+{
+	// lower 7 bits of each byte, so that adding to them does not carry to the next byte
+	auto heptets = w & ~high_bits;
+
+	// high bit of a byte is set in case the byte is greater or equal than 'A'
+	auto ge_a = heptets + ones * (0x80 - 'A');
+
+	// high bit of a byte is set in case the byte is greater than 'Z'
+	auto gt_z = heptets + ones * (0x80 - 'Z' - 1);
+
+	// high bit of a byte is set in case the byte is an upper case letter
+	auto is_upper = (ge_a ^ gt_z) & ~w & high_bits;
+
+	// 0x80 >> 2 = 0x20, which is the difference between upper and lower case letter
+	return w | (is_upper >> 2);
+}
+
+static_assert(to_lower(0x415a5b40617a80c1) == 0x617a5b40617a80c1);
+
+// Loads up to 8 bytes as little-endian word, so that the hash does not depend on the machine byte order.
+// Compilers turn this into a single load on little-endian machines.
+uint64_t load_little_endian(const char* p, size_t size) noexcept
+{
+	uint64_t w = 0;
+	for (size_t i = 0; i != size; ++i) {
+		w |= uint64_t(uint8_t(p[i])) << (i * 8);
+	}
+	return w;
+}
+
+class hasher
+{
+	uint64_t hash = 0;
+
+public:
+	void add(uint64_t w) noexcept
+	{
+		this->hash = (this->hash ^ w) * multiplier;
+		this->hash ^= this->hash >> 32;
+	}
+
+	template <bool lower_case>
+	void add(std::string_view str) noexcept
+	{
+		auto p = str.data();
+		auto end = std::next(p, ptrdiff_t(str.size()));
+
+		for (; std::distance(p, end) >= ptrdiff_t(sizeof(uint64_t)); p = std::next(p, sizeof(uint64_t))) {
+			auto w = load_little_endian(p, sizeof(uint64_t));
+			if constexpr (lower_case) {
+				w = to_lower(w);
+			}
+			this->add(w);
+		}
+
+		if (p != end) {
+			auto w = load_little_endian(p, size_t(std::distance(p, end)));
+			if constexpr (lower_case) {
+				w = to_lower(w);
+			}
+			this->add(w);
+		}
+
+		// string size separates adjacent strings
+		this->add(uint64_t(str.size()));
+	}
+
+	uint64_t get() const noexcept
+	{
+		return detail::mix(this->hash);
+	}
+};
+
+bool equals_ignore_case(std::string_view a, std::string_view lower_case_b) noexcept
+{
+	if (a.size() != lower_case_b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i != a.size(); ++i) {
+		auto c = a[i];
+		if (c >= 'A' && c <= 'Z') {
+			c = char(c - 'A' + 'a');
+		}
+		if (c != lower_case_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+} // namespace
+
+uint16_t urlmodel::get_default_port(std::string_view scheme) noexcept
+{
+	constexpr uint16_t http_port = 80;
+	constexpr uint16_t https_port = 443;
+	constexpr uint16_t ftp_port = 21;
+
+	const std::array<std::pair<std::string_view, uint16_t>, 5> default_ports = {{
+		{"http", http_port},
+		{"https", https_port},
+		{"ws", http_port},
+		{"wss", https_port},
+		{"ftp", ftp_port}
+	}};
+
+	for (const auto& p : default_ports) {
+		if (equals_ignore_case(scheme, p.first)) {
+			return p.second;
+		}
+	}
+	return 0;
+}
+
+uint64_t urlmodel::hash_host(std::string_view host) noexcept
+{
+	hasher h;
+	h.add<true>(host);
+	return h.get();
+}
+
+uint64_t urlmodel::hash_url(const urlmodel::url& url) noexcept
+{
+	hasher h;
+
+	h.add<true>(url.scheme);
+	h.add<true>(url.host);
+
+	auto port = url.port;
+	if (port == get_default_port(url.scheme)) {
+		port = 0;
+	}
+	h.add(uint64_t(port));
+
+	h.add(uint64_t(url.path.size()));
+	for (const auto& s : url.path) {
+		h.add<false>(s);
+	}
+
+	h.add(uint64_t(url.query.size()));
+	for (const auto& q : url.query) {
+		h.add<false>(q.first);
+		h.add<false>(q.second);
+	}
+
+	return h.get();
+}
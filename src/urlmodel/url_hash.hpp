@@ -0,0 +1,68 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "url.hpp"
+
+namespace urlmodel {
+
+/**
+ * @brief Hash URL.
+ * Fast 64-bit hash of the URL components. The hash value is stable between program runs and machines,
+ * regardless of their byte order, so it can be stored or sent to other nodes.
+ * The URL is normalized for hashing:
+ * - scheme and host are case-insensitive;
+ * - port equal to the default port of the scheme, e.g. 80 for http, is same as no port;
+ * - username, password and fragment are ignored, as they do not identify the resource on the server.
+ * Path segments and query parameters are hashed as they are, without percent-decoding.
+ * Query parameters order does not matter, as url::query is ordered.
+ * @param url - URL to hash.
+ * @return hash value.
+ */
+uint64_t hash_url(const urlmodel::url& url) noexcept;
+
+/**
+ * @brief Hash host name.
+ * Host name is case-insensitive.
+ * The hash value is stable between program runs and machines, regardless of their byte order.
+ * @param host - host name.
+ * @return hash value.
+ */
+uint64_t hash_host(std::string_view host) noexcept;
+
+/**
+ * @brief Get default port of the URL scheme.
+ * @param scheme - URL scheme, case-insensitive.
+ * @return default port number, for http, https, ws, wss and ftp schemes.
+ * @return 0 for other schemes.
+ */
+uint16_t get_default_port(std::string_view scheme) noexcept;
+
+} // namespace urlmodel
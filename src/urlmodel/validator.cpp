@@ -0,0 +1,212 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "validator.hpp"
+
+#include <limits>
+#include <string_view>
+
+#include "parser.hpp"
+
+using namespace urlmodel;
+
+namespace {
+enum class state {
+	scheme,
+	authority_prefix,
+	authority,
+	path,
+	query_name,
+	query_value,
+	fragment,
+	end
+};
+
+validation_error check_port(std::string_view port, size_t& offset) noexcept
+{
+	// port must start with at least one digit, characters after the digits are ignored, same as parser does
+
+	uint32_t value = 0;
+	size_t i = 0;
+	for (; i != port.size() && detail::is_digit(port[i]); ++i) {
+		value = value * 10 + uint32_t(port[i] - '0');
+		if (value > std::numeric_limits<uint16_t>::max()) {
+			return validation_error::invalid_port;
+		}
+	}
+
+	if (i == 0 || value == 0) {
+		return validation_error::invalid_port;
+	}
+
+	offset += i;
+	return validation_error::none;
+}
+} // namespace
+
+validation_result urlmodel::validate(utki::span<const uint8_t> data) noexcept
+{
+	const uint8_t* p = data.data();
+	const size_t size = data.size();
+
+	state cur_state = state::scheme;
+	size_t i = 0;
+
+	while (cur_state != state::end) {
+		switch (cur_state) {
+			case state::scheme:
+				for (;; ++i) {
+					if (i == size) {
+						return {validation_error::unexpected_end_of_scheme, i};
+					}
+
+					auto c = detail::to_lower(char(p[i]));
+
+					if (c == '/') {
+						cur_state = state::path;
+						++i;
+						break;
+					} else if (c == ':') {
+						cur_state = state::authority_prefix;
+						++i;
+						break;
+					}
+
+					if (i == 0) {
+						if (!detail::is_alpha(c)) {
+							return {validation_error::scheme_first_char_not_alphabetic, i};
+						}
+					} else if (!(detail::is_alpha(c) || detail::is_digit(c) || c == '+' || c == '-' || c == '.')) {
+						return {validation_error::scheme_forbidden_char, i};
+					}
+				}
+				break;
+			case state::authority_prefix:
+				if (i == size || detail::is_space(char(p[i]))) {
+					cur_state = state::end;
+				} else if (p[i] == '?') {
+					cur_state = state::query_name;
+					++i;
+				} else if (p[i] == '#') {
+					cur_state = state::fragment;
+					++i;
+				} else if (p[i] == '/') {
+					++i;
+					if (i != size && p[i] == '/') {
+						cur_state = state::authority;
+						++i;
+					} else if (i == size || detail::is_space(char(p[i]))) {
+						cur_state = state::end;
+					} else if (p[i] == '?') {
+						cur_state = state::query_name;
+						++i;
+					} else if (p[i] == '#') {
+						cur_state = state::fragment;
+						++i;
+					} else {
+						cur_state = state::path;
+					}
+				} else {
+					return {validation_error::malformed_authority_prefix, i};
+				}
+				break;
+			case state::authority:
+				{
+					auto end = detail::find_end<true, '/', '?', '#'>(p, i, size);
+
+					// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+					std::string_view authority(reinterpret_cast<const char*>(p + i), end - i);
+
+					auto host_pos = authority.find('@');
+					host_pos = host_pos == std::string_view::npos ? 0 : host_pos + 1;
+
+					auto colon_pos = authority.find(':', host_pos);
+					if (colon_pos != std::string_view::npos) {
+						size_t port_offset = i + colon_pos + 1;
+						auto err = check_port(authority.substr(colon_pos + 1), port_offset);
+						if (err != validation_error::none) {
+							return {err, port_offset};
+						}
+					}
+
+					i = end;
+					if (i == size || detail::is_space(char(p[i]))) {
+						cur_state = state::end;
+						break;
+					}
+
+					switch (p[i]) {
+						case '/':
+							cur_state = state::path;
+							break;
+						case '?':
+							cur_state = state::query_name;
+							break;
+						default:
+							ASSERT(p[i] == '#')
+							cur_state = state::fragment;
+							break;
+					}
+					++i;
+				}
+				break;
+			case state::path:
+				i = detail::find_end<true, '?', '#'>(p, i, size);
+				if (i == size || detail::is_space(char(p[i]))) {
+					cur_state = state::end;
+				} else {
+					cur_state = p[i] == '?' ? state::query_name : state::fragment;
+					++i;
+				}
+				break;
+			case state::query_name:
+				i = detail::find_end<true, '='>(p, i, size);
+				if (i == size || detail::is_space(char(p[i]))) {
+					return {validation_error::unexpected_end_of_query_name, i};
+				}
+				cur_state = state::query_value;
+				++i;
+				break;
+			case state::query_value:
+				i = detail::find_end<true, '&', '#'>(p, i, size);
+				if (i == size || detail::is_space(char(p[i]))) {
+					cur_state = state::end;
+				} else {
+					cur_state = p[i] == '&' ? state::query_name : state::fragment;
+					++i;
+				}
+				break;
+			case state::fragment:
+				i = detail::find_end<true>(p, i, size);
+				cur_state = state::end;
+				break;
+			case state::end:
+				break;
+		}
+	}
+
+	return {validation_error::none, i};
+}
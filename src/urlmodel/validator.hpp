@@ -0,0 +1,85 @@
+/*
+MIT License
+
+Copyright (c) 2023 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <utki/span.hpp>
+
+namespace urlmodel {
+
+enum class validation_error {
+	none,
+	scheme_first_char_not_alphabetic,
+	scheme_forbidden_char,
+	unexpected_end_of_scheme,
+	malformed_authority_prefix,
+	invalid_port,
+	unexpected_end_of_query_name
+};
+
+struct validation_result {
+	validation_error error;
+
+	/**
+   * @brief Offset within the validated data.
+   * In case of error, it is the offset of the offending character.
+   * In case of success, it is the offset of the URL end, i.e. the offset of the terminating whitespace
+   * or size of the data in case URL spans till the end of the data.
+   */
+	size_t offset;
+
+	bool is_valid() const noexcept
+	{
+		return this->error == validation_error::none;
+	}
+};
+
+/**
+ * @brief Validate URL.
+ * Checks the URL using the same grammar as urlmodel::parser does, but without building the URL object,
+ * so no memory allocations are done. End of data is treated as end of URL, same as
+ * calling parser::end_of_data() after feeding the whole data to the parser.
+ * @param data - data containing the URL.
+ * @return validation result.
+ */
+validation_result validate(utki::span<const uint8_t> data) noexcept;
+
+/**
+ * @brief Check if URL is valid.
+ * Same as validate(data).is_valid().
+ * @param data - data containing the URL.
+ * @return true if URL is valid.
+ * @return false otherwise.
+ */
+inline bool is_valid(utki::span<const uint8_t> data) noexcept
+{
+	return validate(data).is_valid();
+}
+
+} // namespace urlmodel
@@ -0,0 +1,144 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/compact_url.hpp>
+
+#include "util.hpp"
+
+namespace{
+const tst::set set("urlmodel__compact_url", [](tst::suite& suite){
+    suite.add<urlmodel::url>(
+        "round_trip",
+        {
+            urlmodel::url{},
+            urlmodel::url{
+                .scheme = "http"
+            },
+            urlmodel::url{
+                .scheme = "http",
+                .username = "user",
+                .password = "password"
+            },
+            urlmodel::url{
+                .scheme = "http",
+                .password = "password",
+                .host = "host.com"
+            },
+            urlmodel::url{
+                .host = "host.com",
+                .port = 8080,
+                .path = {"path"}
+            },
+            urlmodel::url{
+                .scheme = "http",
+                .username = "user",
+                .password = "password",
+                .host = "host.com",
+                .port = 8080,
+                .path = {"path", "to", "dir"},
+                .query = {
+                    {"param1", "value1"},
+                    {"param2", "value2"},
+                    {"param3", ""}
+                },
+                .fragment = "fragment"
+            },
+            urlmodel::url{
+                .path = {"path", "to", "dir"},
+                .query = {
+                    {"param1", "value1"}
+                },
+                .fragment = "fragment"
+            },
+            // longer than 64 KiB, needs 32-bit header fields
+            urlmodel::url{
+                .scheme = "http",
+                .host = "host.com",
+                .port = 65535,
+                .path = {std::string(70000, 'a'), "b"},
+                .query = {
+                    {"param1", std::string(100, 'x')}
+                },
+                .fragment = "fragment"
+            }
+        },
+        [](const auto& p){
+            urlmodel::compact_url cu(p);
+
+            tst::check(cu.to_url() == p, SL) << "converted = " << cu.to_url().to_string() << ", expected = " << p.to_string();
+            tst::check_eq(cu.to_string_view(), std::string_view(p.to_string()), SL);
+
+            tst::check_eq(cu.scheme(), std::string_view(p.scheme), SL);
+            tst::check_eq(cu.username(), std::string_view(p.username), SL);
+            tst::check_eq(cu.password(), std::string_view(p.password), SL);
+            tst::check_eq(cu.host(), std::string_view(p.host), SL);
+            tst::check_eq(cu.port(), p.port, SL);
+            tst::check_eq(cu.fragment(), std::string_view(p.fragment), SL);
+
+            tst::check_eq(cu.num_path_segments(), p.path.size(), SL);
+            for(size_t i = 0; i != p.path.size(); ++i){
+                tst::check_eq(cu.path_segment(i), std::string_view(p.path[i]), SL);
+            }
+
+            tst::check_eq(cu.num_query_params(), p.query.size(), SL);
+            for(const auto& q : p.query){
+                tst::check(cu.query_value(q.first) == std::string_view(q.second), SL) << "name = " << q.first;
+            }
+            tst::check(!cu.query_value("no_such_param"), SL);
+
+            auto copy = cu;
+            tst::check(copy == cu, SL);
+            tst::check(copy.to_url() == p, SL);
+        }
+    );
+
+    suite.add("parse", [](){
+        std::string_view str = "http://host.com:8080/path/to/dir?b=2&a=1#fragment";
+
+        auto cu = urlmodel::compact_url::parse(to_span(str));
+
+        tst::check_eq(cu.host(), std::string_view("host.com"), SL);
+        tst::check_eq(cu.port(), uint16_t(8080), SL);
+        tst::check_eq(cu.num_path_segments(), size_t(3), SL);
+        tst::check(cu.query_param(0) == std::make_pair(std::string_view("a"), std::string_view("1")), SL);
+        tst::check_eq(cu.to_string(), std::string("http://host.com:8080/path/to/dir?a=1&b=2#fragment"), SL);
+    });
+
+    suite.add("short_url_has_16_bit_header", [](){
+        std::string_view str = "http://host.com/a/b";
+
+        auto cu = urlmodel::compact_url::parse(to_span(str));
+
+        // field size byte, 5 header fields and offset and size of 5 fixed strings and 2 path segments
+        constexpr size_t header_size = 1 + sizeof(uint16_t) * (5 + (5 + 2) * 2);
+        tst::check_eq(cu.buffer_size(), header_size + str.size(), SL);
+    });
+
+    suite.add("object_is_single_pointer", [](){
+        tst::check_eq(sizeof(urlmodel::compact_url), sizeof(void*), SL);
+    });
+
+    suite.add("copy_and_move", [](){
+        auto cu = urlmodel::compact_url::parse(to_span("http://host.com/a/b?c=d"));
+
+        urlmodel::compact_url copy;
+        copy = cu;
+        tst::check(copy == cu, SL);
+        tst::check_eq(copy.buffer_size(), cu.buffer_size(), SL);
+        tst::check(copy.to_string_view().data() != cu.to_string_view().data(), SL);
+
+        auto moved = std::move(copy);
+        tst::check(moved == cu, SL);
+        tst::check_eq(moved.to_string(), std::string("http://host.com/a/b?c=d"), SL);
+
+        tst::check(!(urlmodel::compact_url() == cu), SL);
+    });
+
+    suite.add("default_is_empty_url", [](){
+        urlmodel::compact_url cu;
+
+        tst::check(cu.to_url() == urlmodel::url(), SL);
+        tst::check(cu == urlmodel::compact_url(urlmodel::url()), SL);
+    });
+});
+}
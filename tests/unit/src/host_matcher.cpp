@@ -0,0 +1,110 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/host_matcher.hpp>
+
+namespace{
+const std::vector<urlmodel::host_matcher::rule> rules = {
+    {"example.com", 1},
+    {"*.example.com", 2},
+    {"*.deep.example.com", 3},
+    {"exact.deep.example.com", 4},
+    {"Mixed.Case.ORG.", 5},
+    {"*.net", 6},
+    {"other.com", 7},
+    {"other.com", 8}
+};
+
+const tst::set set("urlmodel__host_matcher", [](tst::suite& suite){
+    suite.add<std::pair<std::string, std::optional<uint32_t>>>(
+        "match",
+        {
+            {"example.com", 1},
+            {"EXAMPLE.com", 1},
+            {"example.com.", 1},
+            {"www.example.com", 2},
+            {"a.b.c.example.com", 2},
+            {"deep.example.com", 2},
+            {"x.deep.example.com", 3},
+            {"exact.deep.example.com", 4},
+            {"y.exact.deep.example.com", 3},
+            {"mixed.case.org", 5},
+            {"www.mixed.case.org", std::nullopt},
+            {"net", std::nullopt},
+            {"host.net", 6},
+            {"other.com", 8},
+            {"www.other.com", std::nullopt},
+            {"com", std::nullopt},
+            {"ample.com", std::nullopt},
+            {"xexample.com", std::nullopt},
+            {"", std::nullopt},
+            {".", std::nullopt},
+            {"example..com", std::nullopt},
+            {"host.example..com", std::nullopt}
+        },
+        [](const auto& p){
+            urlmodel::host_matcher matcher(rules);
+
+            auto res = matcher.match(p.first);
+
+            tst::check(res == p.second, SL) << "host = " << p.first << ", matched = " << (res ? int(*res) : -1);
+        }
+    );
+
+    suite.add("match_any", [](){
+        std::vector<urlmodel::host_matcher::rule> rules = {
+            {"*", 10},
+            {"example.com", 20}
+        };
+        urlmodel::host_matcher matcher(rules);
+
+        tst::check(matcher.match("example.com") == 20u, SL);
+        tst::check(matcher.match("www.example.com") == 10u, SL);
+        tst::check(matcher.match("localhost") == 10u, SL);
+        tst::check(!matcher.match(""), SL);
+    });
+
+    suite.add("labels_are_shared", [](){
+        std::vector<urlmodel::host_matcher::rule> rules = {
+            {"www.a.com", 0},
+            {"www.b.com", 1},
+            {"a.com", 2}
+        };
+        urlmodel::host_matcher matcher(rules);
+
+        // root, com, a, b, www, www
+        tst::check_eq(matcher.num_nodes(), size_t(6), SL);
+    });
+
+    suite.add("empty_matcher", [](){
+        urlmodel::host_matcher matcher;
+
+        tst::check(!matcher.match("example.com"), SL);
+    });
+
+    suite.add<std::string>(
+        "malformed_rule",
+        {
+            "",
+            ".",
+            "a..com",
+            "*.*.com",
+            "a*.com",
+            "0123456789012345678901234567890123456789012345678901234567890123.com"
+        },
+        [](const auto& p){
+            std::vector<urlmodel::host_matcher::rule> rules = {
+                {p, 0}
+            };
+
+            bool thrown = false;
+            try{
+                urlmodel::host_matcher matcher(rules);
+            }catch(std::invalid_argument&){
+                thrown = true;
+            }
+            tst::check(thrown, SL) << "rule = " << p;
+        }
+    );
+});
+}
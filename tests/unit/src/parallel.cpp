@@ -0,0 +1,59 @@
+#include <atomic>
+#include <stdexcept>
+
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/parallel.hpp>
+
+namespace{
+const tst::set set("urlmodel__parallel", [](tst::suite& suite){
+    suite.add<std::pair<size_t, size_t>>(
+        "parallel_for_chunks_covers_range",
+        {
+            {0, 1},
+            {0, 4},
+            {1, 4},
+            {10, 1},
+            {10, 3},
+            {1000, 7}
+        },
+        [](const auto& p){
+            std::vector<std::atomic<unsigned>> counts(p.first);
+
+            urlmodel::detail::parallel_for_chunks(p.first, p.second, [&](size_t /* chunk */, size_t begin, size_t end){
+                for(size_t i = begin; i != end; ++i){
+                    ++counts[i];
+                }
+            });
+
+            for(size_t i = 0; i != counts.size(); ++i){
+                tst::check_eq(counts[i].load(), 1u, SL) << "i = " << i;
+            }
+        }
+    );
+
+    suite.add("exception_in_calling_thread_joins_threads", [](){
+        constexpr size_t num_chunks = 4;
+
+        std::atomic<size_t> num_finished = 0;
+
+        bool thrown = false;
+        try{
+            urlmodel::detail::parallel_for_chunks(num_chunks * 10, num_chunks, [&](size_t chunk, size_t /* begin */, size_t /* end */){
+                if(chunk == 0){
+                    throw std::runtime_error("chunk 0 failed");
+                }
+                ++num_finished;
+            });
+        }catch(std::runtime_error&){
+            thrown = true;
+        }
+
+        tst::check(thrown, SL);
+
+        // the exception propagates only after all the started threads are joined
+        tst::check_eq(num_finished.load(), num_chunks - 1, SL);
+    });
+});
+}
@@ -0,0 +1,169 @@
+#include <thread>
+
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/parse_cache.hpp>
+
+#include "util.hpp"
+
+namespace{
+const tst::set set("urlmodel__parse_cache", [](tst::suite& suite){
+    suite.add("hit_returns_same_object", [](){
+        urlmodel::parse_cache cache(10);
+
+        auto a = cache.parse_cached(to_span("http://host.com/path?a=b"));
+        auto b = cache.parse_cached(to_span("http://host.com/path?a=b"));
+
+        tst::check(a != nullptr, SL);
+        tst::check_eq(a.get(), b.get(), SL);
+        tst::check_eq(a->host, std::string("host.com"), SL);
+        tst::check_eq(a->path.size(), size_t(1), SL);
+
+        auto stats = cache.get_statistics();
+        tst::check_eq(stats.hits, uint64_t(1), SL);
+        tst::check_eq(stats.misses, uint64_t(1), SL);
+        tst::check_eq(stats.evictions, uint64_t(0), SL);
+    });
+
+    suite.add("eviction", [](){
+        urlmodel::parse_cache cache(2, 1);
+
+        cache.parse_cached(to_span("/a"));
+        cache.parse_cached(to_span("/b"));
+        cache.parse_cached(to_span("/a"));
+
+        // evicts "/b" because "/a" was referenced
+        cache.parse_cached(to_span("/c"));
+
+        auto stats = cache.get_statistics();
+        tst::check_eq(stats.misses, uint64_t(3), SL);
+        tst::check_eq(stats.hits, uint64_t(1), SL);
+        tst::check_eq(stats.evictions, uint64_t(1), SL);
+
+        cache.parse_cached(to_span("/a"));
+        cache.parse_cached(to_span("/c"));
+
+        stats = cache.get_statistics();
+        tst::check_eq(stats.hits, uint64_t(3), SL);
+
+        cache.parse_cached(to_span("/b"));
+
+        stats = cache.get_statistics();
+        tst::check_eq(stats.misses, uint64_t(4), SL);
+        tst::check_eq(stats.evictions, uint64_t(2), SL);
+    });
+
+    suite.add<std::pair<size_t, size_t>>(
+        "capacity_is_not_exceeded",
+        {
+            {1, 16},
+            {5, 16},
+            {10, 3},
+            {16, 16},
+            {100, 7}
+        },
+        [](const auto& p){
+            urlmodel::parse_cache cache(p.first, p.second);
+
+            for(size_t i = 0; i != p.first * 10; ++i){
+                cache.parse_cached(to_span("/" + std::to_string(i)));
+            }
+
+            // all URLs are distinct, so each of them is a miss and the ones not evicted are still cached
+            auto stats = cache.get_statistics();
+            tst::check_eq(stats.hits, uint64_t(0), SL);
+            tst::check(stats.misses - stats.evictions <= p.first, SL)
+                << "cached = " << stats.misses - stats.evictions << ", capacity = " << p.first;
+        }
+    );
+
+    suite.add("long_urls_are_not_cached", [](){
+        urlmodel::parse_cache cache(10, 1, 4);
+
+        auto a = cache.parse_cached(to_span("/path"));
+        auto b = cache.parse_cached(to_span("/path"));
+
+        tst::check_ne(a.get(), b.get(), SL);
+        tst::check(*a == *b, SL);
+        tst::check_eq(cache.get_statistics().misses, uint64_t(2), SL);
+    });
+
+    suite.add("malformed_url_throws", [](){
+        urlmodel::parse_cache cache(10);
+
+        bool thrown = false;
+        try{
+            cache.parse_cached(to_span("1http://host.com"));
+        }catch(std::invalid_argument&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+    });
+
+    suite.add("data_after_url_throws", [](){
+        urlmodel::parse_cache cache(10);
+
+        bool thrown = false;
+        try{
+            cache.parse_cached(to_span("/a b"));
+        }catch(std::invalid_argument&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+
+        // "/a" must not have been cached
+        cache.parse_cached(to_span("/a"));
+        tst::check_eq(cache.get_statistics().hits, uint64_t(0), SL);
+    });
+
+    suite.add("clear", [](){
+        urlmodel::parse_cache cache(10);
+
+        auto a = cache.parse_cached(to_span("/path"));
+        cache.clear();
+        auto b = cache.parse_cached(to_span("/path"));
+
+        tst::check_ne(a.get(), b.get(), SL);
+        tst::check_eq(cache.get_statistics().misses, uint64_t(2), SL);
+    });
+
+    suite.add("concurrent_access", [](){
+        urlmodel::parse_cache cache(64, 4);
+
+        std::vector<std::string> urls;
+        for(unsigned i = 0; i != 100; ++i){
+            urls.push_back("http://host" + std::to_string(i % 10) + ".com/path/" + std::to_string(i));
+        }
+
+        // number of unexpected parse results per thread, checked after joining the threads,
+        // because a failed check in a thread would terminate the program
+        std::vector<size_t> num_failures(4, 0);
+
+        std::vector<std::thread> threads;
+        for(unsigned t = 0; t != num_failures.size(); ++t){
+            threads.emplace_back([&, t](){
+                for(unsigned n = 0; n != 10; ++n){
+                    for(const auto& u : urls){
+                        auto res = cache.parse_cached(to_span(u));
+                        if(res->path.size() != 2){
+                            ++num_failures[t];
+                        }
+                    }
+                }
+            });
+        }
+
+        for(auto& t : threads){
+            t.join();
+        }
+
+        for(size_t t = 0; t != num_failures.size(); ++t){
+            tst::check_eq(num_failures[t], size_t(0), SL) << "thread = " << t;
+        }
+
+        auto stats = cache.get_statistics();
+        tst::check_eq(stats.hits + stats.misses, uint64_t(4 * 10 * 100), SL);
+    });
+});
+}
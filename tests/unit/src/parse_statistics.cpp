@@ -0,0 +1,158 @@
+#include <sstream>
+
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/parser.hpp>
+
+namespace{
+struct instrumented_policy : public urlmodel::parser_policy{
+    using char_type = char;
+    constexpr static bool instrumented = true;
+};
+
+struct instrumented_utf8_policy : public instrumented_policy{
+    constexpr static bool validate_utf8 = true;
+};
+
+struct latency_policy : public instrumented_policy{
+    constexpr static bool measure_latency = true;
+};
+
+uint64_t sum(utki::span<const uint64_t> values){
+    uint64_t ret = 0;
+    for(auto v : values){
+        ret += v;
+    }
+    return ret;
+}
+}
+
+namespace{
+const tst::set set("urlmodel__parse_statistics", [](tst::suite& suite){
+    suite.add("bytes_per_state", [](){
+        urlmodel::parse_statistics stats;
+
+        std::string_view str = "http://host.com/path?param=value#fragment";
+
+        urlmodel::basic_parser<instrumented_policy> parser(stats);
+        parser.feed(str.substr(0, 10));
+        parser.feed(str.substr(10));
+        parser.end_of_data();
+
+        using state = urlmodel::parse_statistics::state;
+
+        tst::check_eq(stats.num_feed_calls, uint64_t(2), SL);
+        tst::check_eq(stats.num_urls, uint64_t(1), SL);
+        tst::check_eq(sum(stats.bytes_per_state), uint64_t(str.size()), SL);
+        tst::check_eq(stats.bytes_per_state[size_t(state::scheme)], uint64_t(5), SL);
+        tst::check_eq(stats.bytes_per_state[size_t(state::authority_prefix)], uint64_t(2), SL);
+        tst::check_eq(stats.bytes_per_state[size_t(state::authority)], uint64_t(9), SL);
+        tst::check_eq(stats.bytes_per_state[size_t(state::path)], uint64_t(5), SL);
+        tst::check_eq(stats.bytes_per_state[size_t(state::query_name)], uint64_t(6), SL);
+        tst::check_eq(stats.bytes_per_state[size_t(state::query_value)], uint64_t(6), SL);
+        tst::check_eq(stats.bytes_per_state[size_t(state::fragment)], uint64_t(8), SL);
+        tst::check_eq(sum(stats.errors_per_state), uint64_t(0), SL);
+        tst::check(stats.num_buf_reallocations != 0, SL);
+
+        // one query map node
+        tst::check(stats.num_url_heap_buffers != 0, SL);
+
+        tst::check_eq(sum(stats.latency_histogram), uint64_t(0), SL);
+    });
+
+    suite.add("errors_per_state", [](){
+        urlmodel::parse_statistics stats;
+
+        for(std::string_view str : {"1http://host.com", "http://host.com:0/", "http://host.com/?param", "http:x"}){
+            urlmodel::basic_parser<instrumented_policy> parser(stats);
+            try{
+                parser.feed(str);
+                parser.end_of_data();
+                tst::check(false, SL) << "no exception thrown";
+            }catch(std::invalid_argument&){}
+        }
+
+        using state = urlmodel::parse_statistics::state;
+
+        tst::check_eq(stats.num_urls, uint64_t(0), SL);
+        tst::check_eq(stats.errors_per_state[size_t(state::scheme)], uint64_t(1), SL);
+        tst::check_eq(stats.errors_per_state[size_t(state::authority)], uint64_t(1), SL);
+        tst::check_eq(stats.errors_per_state[size_t(state::query_name)], uint64_t(1), SL);
+        tst::check_eq(stats.errors_per_state[size_t(state::authority_prefix)], uint64_t(1), SL);
+    });
+
+    suite.add("utf8_errors_per_state", [](){
+        urlmodel::parse_statistics stats;
+
+        // UTF-8 errors are detected after the parser moves on to the next state, possibly to the end of URL,
+        // the errors are counted for the state which consumed the invalid bytes
+        for(std::string_view str : {
+            "/a\xff b",
+            "http://h\xffst.com/",
+            "/a?b\xff=c",
+            "/a?b=\xc3"
+        }){
+            urlmodel::basic_parser<instrumented_utf8_policy> parser(stats);
+            bool thrown = false;
+            try{
+                parser.feed(str);
+                parser.end_of_data();
+            }catch(urlmodel::utf8_error&){
+                thrown = true;
+            }
+            tst::check(thrown, SL) << "str = " << str;
+        }
+
+        using state = urlmodel::parse_statistics::state;
+
+        tst::check_eq(sum(stats.errors_per_state), uint64_t(4), SL);
+        tst::check_eq(stats.errors_per_state[size_t(state::path)], uint64_t(1), SL);
+        tst::check_eq(stats.errors_per_state[size_t(state::authority)], uint64_t(1), SL);
+        tst::check_eq(stats.errors_per_state[size_t(state::query_name)], uint64_t(1), SL);
+        tst::check_eq(stats.errors_per_state[size_t(state::query_value)], uint64_t(1), SL);
+    });
+
+    suite.add("latency", [](){
+        urlmodel::parse_statistics stats;
+
+        for(unsigned i = 0; i != 10; ++i){
+            urlmodel::basic_parser<latency_policy> parser(stats, urlmodel::component::host);
+            parser.feed(std::string_view("http://host.com/path"));
+            parser.end_of_data();
+        }
+
+        tst::check_eq(stats.num_urls, uint64_t(10), SL);
+        tst::check_eq(sum(stats.latency_histogram), uint64_t(10), SL);
+    });
+
+    suite.add("merge_and_write", [](){
+        urlmodel::parse_statistics a;
+        a.num_feed_calls = 1;
+        a.bytes_per_state[size_t(urlmodel::parse_statistics::state::path)] = 10;
+        a.add_latency(0);
+        a.add_latency(1000);
+
+        urlmodel::parse_statistics b;
+        b.num_feed_calls = 2;
+        b.bytes_per_state[size_t(urlmodel::parse_statistics::state::path)] = 5;
+        b.add_latency(1023);
+
+        a += b;
+
+        tst::check_eq(a.num_feed_calls, uint64_t(3), SL);
+        tst::check_eq(a.bytes_per_state[size_t(urlmodel::parse_statistics::state::path)], uint64_t(15), SL);
+        tst::check_eq(a.latency_histogram[0], uint64_t(1), SL);
+        tst::check_eq(a.latency_histogram[9], uint64_t(2), SL);
+
+        std::stringstream ss;
+        a.write(ss);
+
+        auto str = ss.str();
+        tst::check(str.find("feed_calls 3\n") != std::string::npos, SL) << str;
+        tst::check(str.find("bytes.path 15\n") != std::string::npos, SL) << str;
+        tst::check(str.find("latency_ns.0 1\n") != std::string::npos, SL) << str;
+        tst::check(str.find("latency_ns.512 2\n") != std::string::npos, SL) << str;
+    });
+});
+}
@@ -0,0 +1,224 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/request_line_parser.hpp>
+
+#include "util.hpp"
+
+namespace{
+struct request_line{
+    std::string method;
+    urlmodel::request_line_parser::target_form form;
+    urlmodel::url target;
+    uint8_t version_major;
+    uint8_t version_minor;
+};
+}
+
+namespace{
+const tst::set set("urlmodel__request_line_parser", [](tst::suite& suite){
+    suite.add<std::pair<std::string_view, request_line>>(
+        "samples",
+        {
+            {
+                "GET / HTTP/1.1\r\n",
+                {
+                    .method = "GET",
+                    .form = urlmodel::request_line_parser::target_form::origin,
+                    .target = {},
+                    .version_major = 1,
+                    .version_minor = 1
+                }
+            },
+            {
+                "GET /where?q=now HTTP/1.1\r\n",
+                {
+                    .method = "GET",
+                    .form = urlmodel::request_line_parser::target_form::origin,
+                    .target = {
+                        .path = {"where"},
+                        .query = {{"q", "now"}}
+                    },
+                    .version_major = 1,
+                    .version_minor = 1
+                }
+            },
+            {
+                "POST http://www.example.org:8080/pub/index.html HTTP/1.0\r\n",
+                {
+                    .method = "POST",
+                    .form = urlmodel::request_line_parser::target_form::absolute,
+                    .target = {
+                        .scheme = "http",
+                        .host = "www.example.org",
+                        .port = 8080,
+                        .path = {"pub", "index.html"}
+                    },
+                    .version_major = 1,
+                    .version_minor = 0
+                }
+            },
+            {
+                "CONNECT www.example.com:443 HTTP/1.1\r\n",
+                {
+                    .method = "CONNECT",
+                    .form = urlmodel::request_line_parser::target_form::authority,
+                    .target = {
+                        .host = "www.example.com",
+                        .port = 443
+                    },
+                    .version_major = 1,
+                    .version_minor = 1
+                }
+            },
+            {
+                "CONNECT [::1]:8080 HTTP/1.1\r\n",
+                {
+                    .method = "CONNECT",
+                    .form = urlmodel::request_line_parser::target_form::authority,
+                    .target = {
+                        .host = "[::1]",
+                        .port = 8080
+                    },
+                    .version_major = 1,
+                    .version_minor = 1
+                }
+            },
+            {
+                "OPTIONS * HTTP/1.1\r\n",
+                {
+                    .method = "OPTIONS",
+                    .form = urlmodel::request_line_parser::target_form::asterisk,
+                    .target = {},
+                    .version_major = 1,
+                    .version_minor = 1
+                }
+            },
+            // empty lines before request-line and bare LF line terminator
+            {
+                "\r\n\r\nDELETE /a/b HTTP/1.1\n",
+                {
+                    .method = "DELETE",
+                    .form = urlmodel::request_line_parser::target_form::origin,
+                    .target = {
+                        .path = {"a", "b"}
+                    },
+                    .version_major = 1,
+                    .version_minor = 1
+                }
+            }
+        },
+        [](const auto& p){
+            // feed whole line at once and byte by byte
+            for(size_t chunk_size : {p.first.size(), size_t(1)}){
+                urlmodel::request_line_parser parser;
+
+                std::string_view str = p.first;
+                while(!str.empty()){
+                    tst::check(!parser.is_end(), SL);
+                    auto chunk = str.substr(0, chunk_size);
+                    str = str.substr(chunk.size());
+                    auto rest = parser.feed(to_span(chunk));
+                    tst::check(rest.empty(), SL);
+                }
+
+                tst::check(parser.is_end(), SL);
+
+                const auto& e = p.second;
+                tst::check_eq(parser.method, e.method, SL);
+                tst::check(parser.form == e.form, SL);
+                tst::check(parser.target == e.target, SL) << "parsed = " << parser.target.to_string() << ", expected = " << e.target.to_string();
+                tst::check_eq(parser.version_major, e.version_major, SL);
+                tst::check_eq(parser.version_minor, e.version_minor, SL);
+            }
+        }
+    );
+
+    suite.add("rest_of_data_is_returned", [](){
+        urlmodel::request_line_parser parser;
+
+        auto rest = parser.feed(to_span("GET /index.html HTTP/1.1\r\nHost: example.org\r\n\r\n"));
+
+        tst::check(parser.is_end(), SL);
+        tst::check_eq(utki::make_string_view(rest), std::string_view("Host: example.org\r\n\r\n"), SL);
+
+        tst::check(parser.target == urlmodel::url{.path = {"index.html"}}, SL);
+    });
+
+    suite.add("wanted_components", [](){
+        urlmodel::request_line_parser parser(urlmodel::component::path);
+
+        auto rest = parser.feed(to_span("GET /some/path?a=b&c=d#frag HTTP/1.1\r\n"));
+
+        tst::check(parser.is_end(), SL);
+        tst::check(rest.empty(), SL);
+
+        tst::check(parser.target == urlmodel::url{.path = {"some", "path"}}, SL) << "parsed = " << parser.target.to_string();
+        tst::check_eq(parser.version_minor, uint8_t(1), SL);
+    });
+
+    suite.add("method_size_is_limited", [](){
+        {
+            urlmodel::request_line_parser parser;
+            parser.feed(to_span(std::string(32, 'M') + " / HTTP/1.1\r\n"));
+            tst::check(parser.is_end(), SL);
+            tst::check_eq(parser.method, std::string(32, 'M'), SL);
+        }
+
+        urlmodel::request_line_parser parser;
+
+        const std::string chunk(1024, 'M');
+
+        size_t num_fed = 0;
+        bool thrown = false;
+        try{
+            for(; num_fed != 1024; ++num_fed){
+                parser.feed(to_span(chunk));
+            }
+        }catch(std::invalid_argument&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+        tst::check_eq(num_fed, size_t(0), SL);
+        tst::check(parser.method.size() <= 32, SL);
+    });
+
+    suite.add<std::string_view>(
+        "malformed",
+        {
+            " / HTTP/1.1\r\n",
+            "G(T / HTTP/1.1\r\n",
+            "GET  / HTTP/1.1\r\n",
+            "GET /\r\n",
+            "GET / \r\n",
+            "GET /\tHTTP/1.1\r\n",
+            "GET / HTTP/1.1 \r\n",
+            "GET / HTTP/11\r\n",
+            "GET / http/1.1\r\n",
+            "GET / HTTP/1.10\r\n",
+            "GET / HTTP/1.1\rX",
+            "GET * HTTP/1.1\r\n",
+            "GET ? HTTP/1.1\r\n",
+            "GET 1http://host HTTP/1.1\r\n",
+            "CONNECT www.example.com HTTP/1.1\r\n",
+            "CONNECT :443 HTTP/1.1\r\n",
+            "CONNECT user@www.example.com:443 HTTP/1.1\r\n",
+            "CONNECT www.example.com:0 HTTP/1.1\r\n",
+            "CONNECT www.example.com:65536 HTTP/1.1\r\n",
+            "CONNECT www.example.com:44x HTTP/1.1\r\n",
+            "MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM / HTTP/1.1\r\n"
+        },
+        [](const auto& p){
+            urlmodel::request_line_parser parser;
+
+            bool thrown = false;
+            try{
+                parser.feed(to_span(p));
+            }catch(std::invalid_argument&){
+                thrown = true;
+            }
+            tst::check(thrown, SL);
+        }
+    );
+});
+}
@@ -0,0 +1,156 @@
+#include <array>
+#include <utility>
+
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/route_table.hpp>
+
+namespace{
+constexpr auto routes = urlmodel::make_route_table<int>({
+    {"/", 0},
+    {"/api/users", 1},
+    {"/api/groups", 2},
+    {"/api/users/list", 3},
+    {"/api//groups/list/", 4},
+    {"/static/index.html", 5},
+    {"/static/style.css", 6},
+    {"/a/b", 7},
+    {"/ab", 8},
+    {"/b/a", 9}
+});
+
+// the table is built at compile time
+static_assert(routes.size() == 10);
+static_assert(routes.find("/api/users") == 1);
+static_assert(routes.find("api/users/") == 1);
+static_assert(routes.find("/api/groups/list") == 4);
+static_assert(routes.find("") == 0);
+static_assert(!routes.find("/api").has_value());
+
+// large table built at compile time, the build must stay within compiler's constexpr evaluation limits
+constexpr size_t num_generated_routes = 2000;
+
+// "/route/NNNN" paths
+constexpr auto generated_paths = [](){
+    std::array<std::array<char, 11>, num_generated_routes> ret{};
+    for(size_t i = 0; i != ret.size(); ++i){
+        auto& p = ret[i];
+        const char prefix[] = "/route/";
+        for(size_t j = 0; j != 7; ++j){
+            p[j] = prefix[j];
+        }
+        p[7] = char('0' + i / 1000 % 10);
+        p[8] = char('0' + i / 100 % 10);
+        p[9] = char('0' + i / 10 % 10);
+        p[10] = char('0' + i % 10);
+    }
+    return ret;
+}();
+
+template <size_t... indices>
+constexpr auto make_generated_table(std::index_sequence<indices...>){
+    const std::pair<std::string_view, int> arr[] = {
+        {std::string_view(generated_paths[indices].data(), generated_paths[indices].size()), int(indices)}...
+    };
+    return urlmodel::make_route_table<int>(arr);
+}
+
+constexpr auto generated_routes = make_generated_table(std::make_index_sequence<num_generated_routes>());
+
+static_assert(generated_routes.size() == num_generated_routes);
+static_assert(generated_routes.find("/route/0000") == 0);
+static_assert(generated_routes.find("/route/1234") == 1234);
+static_assert(generated_routes.find("/route/1999") == 1999);
+static_assert(!generated_routes.find("/route/2000").has_value());
+}
+
+namespace{
+const tst::set set("urlmodel__route_table", [](tst::suite& suite){
+    suite.add<std::pair<std::vector<std::string>, std::optional<int>>>(
+        "find_path",
+        {
+            {{}, 0},
+            {{"api", "users"}, 1},
+            {{"api", "groups"}, 2},
+            {{"api", "users", "list"}, 3},
+            {{"api", "groups", "list"}, 4},
+            {{"static", "index.html"}, 5},
+            {{"static", "style.css"}, 6},
+            {{"a", "b"}, 7},
+            {{"ab"}, 8},
+            {{"b", "a"}, 9},
+            // empty segments are ignored
+            {{"", "api", "", "users", ""}, 1},
+            {{""}, 0},
+            {{"api"}, std::nullopt},
+            {{"api", "users", "list", "more"}, std::nullopt},
+            {{"API", "users"}, std::nullopt},
+            {{"b"}, std::nullopt},
+            {{"ba"}, std::nullopt},
+            {{"static", "index.htm"}, std::nullopt}
+        },
+        [](const auto& p){
+            auto res = routes.find(p.first);
+            tst::check(res == p.second, SL) << "res = " << res.value_or(-1);
+        }
+    );
+
+    suite.add<std::pair<std::string_view, std::optional<int>>>(
+        "find_string",
+        {
+            {"/", 0},
+            {"///", 0},
+            {"/api/users", 1},
+            {"/api/users/list", 3},
+            {"//api//groups//list//", 4},
+            {"/api/user", std::nullopt},
+            {"/a/b/c", std::nullopt}
+        },
+        [](const auto& p){
+            auto res = routes.find(p.first);
+            tst::check(res == p.second, SL) << "res = " << res.value_or(-1);
+        }
+    );
+
+    suite.add("many_routes", [](){
+        std::vector<std::string> paths;
+        for(int i = 0; i != 200; ++i){
+            paths.push_back("/route/" + std::to_string(i));
+        }
+
+        std::vector<std::pair<std::string_view, int>> r;
+        for(int i = 0; i != 200; ++i){
+            r.emplace_back(paths[i], i);
+        }
+
+        std::pair<std::string_view, int> arr[200];
+        std::copy(r.begin(), r.end(), std::begin(arr));
+
+        // build the table at run time
+        auto table = urlmodel::make_route_table<int>(arr);
+
+        for(int i = 0; i != 200; ++i){
+            tst::check(table.find(std::vector<std::string>{"route", std::to_string(i)}) == i, SL);
+        }
+        tst::check(!table.find("/route/200").has_value(), SL);
+        tst::check(!table.find("/route").has_value(), SL);
+    });
+
+    suite.add("duplicate_routes", [](){
+        std::pair<std::string_view, int> arr[] = {
+            {"/a/b", 1},
+            {"/c", 2},
+            {"a//b/", 3}
+        };
+
+        bool thrown = false;
+        try{
+            urlmodel::make_route_table<int>(arr);
+        }catch(std::invalid_argument&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+    });
+});
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/seen_set.hpp>
+
+namespace{
+std::vector<urlmodel::url> make_urls(size_t begin, size_t end){
+    std::vector<urlmodel::url> ret;
+    for(size_t i = begin; i != end; ++i){
+        urlmodel::url u;
+        u.scheme = "http";
+        u.host = "host" + std::to_string(i % 100) + ".com";
+        u.path = {"path", std::to_string(i)};
+        ret.push_back(std::move(u));
+    }
+    return ret;
+}
+
+struct alignas(64) aligned_block{
+    std::array<uint8_t, 64> bytes;
+};
+}
+
+namespace{
+const tst::set set("urlmodel__seen_set", [](tst::suite& suite){
+    suite.add("insert_and_contains", [](){
+        urlmodel::seen_set s(1000, 0.01);
+
+        auto urls = make_urls(0, 1000);
+
+        size_t num_inserted = 0;
+        for(const auto& u : urls){
+            // new URL can be reported as already seen in case of false positive
+            if(s.insert(u)){
+                ++num_inserted;
+            }
+            tst::check(!s.insert(u), SL);
+            tst::check(s.contains(u), SL);
+        }
+        tst::check(num_inserted > 980, SL) << "num_inserted = " << num_inserted;
+
+        // no false negatives
+        for(const auto& u : urls){
+            tst::check(s.contains(u), SL);
+        }
+    });
+
+    suite.add<double>(
+        "false_positive_rate",
+        {0.1, 0.01, 0.001},
+        [](const auto& p){
+            constexpr size_t num_urls = 10000;
+            constexpr size_t num_checks = 100000;
+
+            urlmodel::seen_set s(num_urls, p);
+            s.insert(make_urls(0, num_urls));
+
+            auto others = make_urls(num_urls, num_urls + num_checks);
+
+            size_t num_false_positives = 0;
+            for(const auto& u : others){
+                if(s.contains(u)){
+                    ++num_false_positives;
+                }
+            }
+
+            auto rate = double(num_false_positives) / double(num_checks);
+            tst::check(rate < p * 1.5, SL) << "rate = " << rate << ", expected = " << p;
+        }
+    );
+
+    suite.add("bulk_operations_give_same_results", [](){
+        urlmodel::seen_set bulk(500, 0.01);
+        urlmodel::seen_set single(500, 0.01);
+
+        auto urls = make_urls(0, 500);
+        bulk.insert(urls);
+        for(const auto& u : urls){
+            single.insert(u);
+        }
+
+        auto bulk_data = bulk.get_data();
+        auto single_data = single.get_data();
+        tst::check(std::equal(bulk_data.begin(), bulk_data.end(), single_data.begin(), single_data.end()), SL);
+
+        auto checked = make_urls(250, 1037);
+        auto results = std::make_unique<bool[]>(checked.size());
+        bulk.contains(checked, utki::make_span(results.get(), checked.size()));
+
+        for(size_t i = 0; i != checked.size(); ++i){
+            tst::check_eq(results[i], single.contains(checked[i]), SL) << "i = " << i;
+        }
+    });
+
+    suite.add("construct_on_saved_data", [](){
+        urlmodel::seen_set s(1000, 0.01);
+
+        auto urls = make_urls(0, 1000);
+        s.insert(urls);
+
+        auto data = s.get_data();
+        tst::check_eq(data.size() % 64, size_t(0), SL);
+
+        std::vector<aligned_block> buf(data.size() / sizeof(aligned_block));
+        auto bytes = utki::make_span(buf.front().bytes.data(), data.size());
+        std::copy(data.begin(), data.end(), bytes.begin());
+
+        urlmodel::seen_set view(bytes);
+        tst::check_eq(view.get_num_hashes(), s.get_num_hashes(), SL);
+
+        for(const auto& u : urls){
+            tst::check(view.contains(u), SL);
+        }
+
+        // inserting to the view modifies the external memory
+        auto more = make_urls(1000, 1100);
+        view.insert(more);
+        tst::check(view.get_data().data() == bytes.data(), SL);
+        tst::check(!std::equal(data.begin(), data.end(), bytes.begin()), SL);
+    });
+
+    suite.add("move", [](){
+        auto urls = make_urls(0, 100);
+
+        urlmodel::seen_set s(100, 0.01);
+        s.insert(urls);
+
+        urlmodel::seen_set moved(std::move(s));
+        // NOLINTNEXTLINE(bugprone-use-after-move)
+        tst::check(s.get_data().empty(), SL);
+
+        urlmodel::seen_set assigned(1, 0.5);
+        assigned = std::move(moved);
+        // NOLINTNEXTLINE(bugprone-use-after-move)
+        tst::check(moved.get_data().empty(), SL);
+
+        for(const auto& u : urls){
+            tst::check(assigned.contains(u), SL);
+        }
+    });
+
+    suite.add("invalid_parameters", [](){
+        for(auto p : {0.0, 1.0, -0.5, 2.0}){
+            bool thrown = false;
+            try{
+                urlmodel::seen_set s(100, p);
+            }catch(std::invalid_argument&){
+                thrown = true;
+            }
+            tst::check(thrown, SL) << "p = " << p;
+        }
+
+        bool thrown = false;
+        try{
+            urlmodel::seen_set s(0, 0.01);
+        }catch(std::invalid_argument&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+    });
+
+    suite.add<std::string>(
+        "malformed_data",
+        {
+            "too_small",
+            "bad_magic",
+            "bad_version",
+            "bad_num_hashes",
+            "bad_num_blocks",
+            "unaligned"
+        },
+        [](const auto& p){
+            urlmodel::seen_set s(100, 0.01);
+            auto data = s.get_data();
+
+            std::vector<aligned_block> buf(data.size() / sizeof(aligned_block) + 1);
+            auto bytes = utki::make_span(buf.front().bytes.data(), data.size());
+            std::copy(data.begin(), data.end(), bytes.begin());
+
+            if(p == "too_small"){
+                bytes = bytes.subspan(0, 32);
+            }else if(p == "bad_magic"){
+                bytes[0] = 'U';
+            }else if(p == "bad_version"){
+                uint32_t version = 2;
+                std::memcpy(bytes.data() + 8, &version, sizeof(version));
+            }else if(p == "bad_num_hashes"){
+                uint32_t num_hashes = 0;
+                std::memcpy(bytes.data() + 12, &num_hashes, sizeof(num_hashes));
+            }else if(p == "bad_num_blocks"){
+                bytes = bytes.subspan(0, bytes.size() - 64);
+            }else if(p == "unaligned"){
+                bytes = utki::make_span(bytes.data() + 1, bytes.size());
+            }
+
+            bool thrown = false;
+            try{
+                urlmodel::seen_set view(bytes);
+            }catch(std::invalid_argument&){
+                thrown = true;
+            }
+            tst::check(thrown, SL) << "p = " << p;
+        }
+    );
+});
+}
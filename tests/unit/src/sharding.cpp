@@ -0,0 +1,148 @@
+#include <algorithm>
+
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/sharding.hpp>
+#include <urlmodel/url_hash.hpp>
+
+namespace{
+std::vector<urlmodel::url> make_urls(size_t num_urls, size_t num_hosts){
+    std::vector<urlmodel::url> ret;
+    for(size_t i = 0; i != num_urls; ++i){
+        urlmodel::url u;
+        u.scheme = "http";
+        u.host = "host" + std::to_string(i % num_hosts) + ".com";
+        u.port = i % 3 == 0 ? 8080 : 0;
+        u.path = {"path", std::to_string(i)};
+        ret.push_back(std::move(u));
+    }
+    return ret;
+}
+}
+
+namespace{
+const tst::set set("urlmodel__sharding", [](tst::suite& suite){
+    suite.add("jump_consistent_hash_is_stable", [](){
+        // shard assignment must not change between library versions
+        tst::check_eq(urlmodel::jump_consistent_hash(0, 1), uint32_t(0), SL);
+        tst::check_eq(urlmodel::jump_consistent_hash(0, 100), uint32_t(0), SL);
+        tst::check_eq(urlmodel::jump_consistent_hash(1, 100), uint32_t(55), SL);
+        tst::check_eq(urlmodel::jump_consistent_hash(0xdeadbeef, 1000), uint32_t(285), SL);
+
+        for(uint64_t key = 0; key != 1000; ++key){
+            tst::check_eq(urlmodel::jump_consistent_hash(key, 1), uint32_t(0), SL);
+            tst::check(urlmodel::jump_consistent_hash(key, 10) < 10, SL);
+        }
+    });
+
+    suite.add<uint32_t>(
+        "minimal_reshuffling",
+        {1, 2, 7, 10, 100},
+        [](const auto& p){
+            constexpr size_t num_keys = 100000;
+
+            size_t num_moved = 0;
+            for(uint64_t key = 0; key != num_keys; ++key){
+                auto k = urlmodel::hash_host(std::to_string(key));
+                auto a = urlmodel::jump_consistent_hash(k, p);
+                auto b = urlmodel::jump_consistent_hash(k, p + 1);
+                if(a != b){
+                    // keys only move to the new bucket
+                    tst::check_eq(b, p, SL);
+                    ++num_moved;
+                }
+            }
+
+            auto expected = double(num_keys) / double(p + 1);
+            tst::check(double(num_moved) > expected * 0.9 && double(num_moved) < expected * 1.1, SL)
+                << "num_moved = " << num_moved << ", expected = " << expected;
+        }
+    );
+
+    suite.add("same_host_goes_to_same_shard", [](){
+        urlmodel::sharder sharder(16);
+
+        auto urls = make_urls(1000, 10);
+        for(const auto& u : urls){
+            urlmodel::url other;
+            other.scheme = "https";
+            other.host = u.host;
+            other.path = {"other"};
+            tst::check_eq(sharder.get_shard(u), sharder.get_shard(other), SL) << "host = " << u.host;
+        }
+
+        urlmodel::url upper;
+        upper.host = "HOST1.COM";
+        tst::check_eq(sharder.get_shard(upper), sharder.get_shard(urls[1]), SL);
+    });
+
+    suite.add("use_port", [](){
+        urlmodel::sharder sharder(1000, true);
+
+        urlmodel::url a;
+        a.scheme = "http";
+        a.host = "host.com";
+
+        auto b = a;
+        b.port = 80;
+
+        auto c = a;
+        c.port = 8080;
+
+        tst::check_eq(sharder.get_key(a), sharder.get_key(b), SL);
+        tst::check(sharder.get_key(a) != sharder.get_key(c), SL);
+
+        urlmodel::sharder host_only(1000);
+        tst::check_eq(host_only.get_key(a), host_only.get_key(c), SL);
+        tst::check_eq(host_only.get_key(a), urlmodel::hash_host("host.com"), SL);
+    });
+
+    suite.add<std::pair<size_t, unsigned>>(
+        "partition",
+        {
+            {0, 1},
+            {1, 1},
+            {1000, 1},
+            {1000, 0},
+            {50000, 4},
+            {50000, 3}
+        },
+        [](const auto& p){
+            urlmodel::sharder sharder(13, true);
+
+            auto urls = make_urls(p.first, 500);
+
+            auto buckets = sharder.partition(urls, p.second);
+            tst::check_eq(buckets.size(), sharder.get_num_shards(), SL);
+
+            std::vector<bool> seen(urls.size(), false);
+            for(uint32_t s = 0; s != buckets.size(); ++s){
+                auto bucket = buckets[s];
+                for(size_t i = 0; i != bucket.size(); ++i){
+                    auto index = bucket[i];
+                    tst::check(index < urls.size(), SL);
+                    tst::check(!seen[index], SL);
+                    seen[index] = true;
+                    tst::check_eq(sharder.get_shard(urls[index]), s, SL);
+                    if(i != 0){
+                        tst::check(bucket[i - 1] < index, SL);
+                    }
+                }
+            }
+
+            tst::check(std::all_of(seen.begin(), seen.end(), [](bool b){return b;}), SL);
+        }
+    );
+
+    suite.add("zero_shards_throws", [](){
+        bool thrown = false;
+        try{
+            urlmodel::sharder sharder(0);
+        }catch(std::invalid_argument&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+    });
+});
+}
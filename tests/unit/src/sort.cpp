@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <random>
+
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/sort.hpp>
+
+namespace{
+std::string make_random_string(std::mt19937& gen){
+    // small alphabet to have many equal prefixes, including bytes which need escaping in radix sort keys
+    const std::string_view alphabet("\0\x01" "abc\xff", 6);
+
+    std::uniform_int_distribution<size_t> size_dist(0, 4);
+    std::uniform_int_distribution<size_t> char_dist(0, alphabet.size() - 1);
+
+    std::string ret;
+    for(auto size = size_dist(gen); size != 0; --size){
+        ret.push_back(alphabet[char_dist(gen)]);
+    }
+    return ret;
+}
+
+std::vector<std::string> make_random_path(std::mt19937& gen){
+    std::uniform_int_distribution<size_t> size_dist(0, 4);
+
+    std::vector<std::string> ret;
+    for(auto size = size_dist(gen); size != 0; --size){
+        ret.push_back(make_random_string(gen));
+    }
+    return ret;
+}
+
+bool host_and_path_less(const urlmodel::url& a, const urlmodel::url& b){
+    if(a.host != b.host){
+        return a.host < b.host;
+    }
+    return urlmodel::path_less()(a.path, b.path);
+}
+}
+
+namespace{
+const tst::set set("urlmodel__sort", [](tst::suite& suite){
+    // small sizes are sorted in single thread, big ones in parallel
+    suite.add<std::pair<size_t, unsigned>>(
+        "sort_paths",
+        {
+            {0, 1},
+            {1, 1},
+            {10, 1},
+            {1000, 1},
+            {1000, 0},
+            {50000, 4}
+        },
+        [](const auto& p){
+            std::mt19937 gen(1);
+
+            std::vector<std::vector<std::string>> paths;
+            for(size_t i = 0; i != p.first; ++i){
+                paths.push_back(make_random_path(gen));
+            }
+
+            auto expected = paths;
+            std::stable_sort(expected.begin(), expected.end(), urlmodel::path_less());
+
+            urlmodel::sort_paths(paths, p.second);
+
+            tst::check(paths == expected, SL);
+        }
+    );
+
+    suite.add<std::pair<size_t, unsigned>>(
+        "sort_by_host_and_path",
+        {
+            {10, 1},
+            {1000, 1},
+            {50000, 4}
+        },
+        [](const auto& p){
+            std::mt19937 gen(2);
+
+            std::vector<urlmodel::url> urls;
+            for(size_t i = 0; i != p.first; ++i){
+                urls.push_back(urlmodel::url{
+                    .host = make_random_string(gen),
+                    .path = make_random_path(gen),
+                    // to check that the sort is stable
+                    .fragment = std::to_string(i)
+                });
+            }
+
+            auto expected = urls;
+            std::stable_sort(expected.begin(), expected.end(), &host_and_path_less);
+
+            urlmodel::sort_by_host_and_path(urls, p.second);
+
+            tst::check(urls == expected, SL);
+        }
+    );
+
+    suite.add("group_by_path_prefix", [](){
+        std::vector<urlmodel::url> urls = {
+            {.host = "b.com", .path = {"a", "b", "c"}},
+            {.host = "a.com", .path = {"x", "y"}},
+            {.host = "a.com", .path = {"a"}},
+            {.host = "a.com", .path = {"a", "b"}},
+            {.host = "a.com", .path = {"a", "b", "c"}},
+            {.host = "a.com", .path = {"a", "c"}},
+            {.host = "a.com", .path = {"a", "b", "d"}},
+            {.host = "b.com", .path = {"a", "b"}}
+        };
+
+        urlmodel::sort_by_host_and_path(urls);
+
+        auto groups = urlmodel::group_by_path_prefix(urls, 2);
+
+        std::vector<size_t> group_sizes;
+        for(const auto& g : groups){
+            group_sizes.push_back(g.size());
+            for(const auto& u : g){
+                tst::check_eq(u.host, g.front().host, SL);
+            }
+        }
+
+        // a.com/a, a.com/a/b*, a.com/a/c, a.com/x/y, b.com/a/b*
+        tst::check(group_sizes == std::vector<size_t>{1, 3, 1, 1, 2}, SL);
+
+        tst::check(urlmodel::group_by_path_prefix(urls, 0).size() == 2, SL);
+    });
+
+    suite.add("group_paths_by_path_prefix", [](){
+        std::vector<std::vector<std::string>> paths = {
+            {"a", "b"},
+            {"b"},
+            {"a"},
+            {"a", "c", "d"},
+            {"a", "c"},
+            {}
+        };
+
+        urlmodel::sort_paths(paths);
+
+        auto groups = urlmodel::group_by_path_prefix(paths, 1);
+
+        // {}, {"a"...}, {"b"}
+        tst::check_eq(groups.size(), size_t(3), SL);
+        tst::check_eq(groups[1].size(), size_t(4), SL);
+
+        tst::check(urlmodel::group_by_path_prefix(utki::span<const std::vector<std::string>>(), 1).empty(), SL);
+    });
+});
+}
@@ -0,0 +1,318 @@
+#include <map>
+
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <urlmodel/parser.hpp>
+#include <urlmodel/uri_template.hpp>
+
+#include "util.hpp"
+
+namespace{
+using value = urlmodel::uri_template::value;
+
+// variables from RFC 6570 section 3.2.1
+const std::string_view count[] = {"one", "two", "three"};
+const std::string_view dom[] = {"example", "com"};
+const std::string_view list[] = {"red", "green", "blue"};
+const std::pair<std::string_view, std::string_view> keys[] = {{"semi", ";"}, {"dot", "."}, {"comma", ","}};
+
+const std::map<std::string, value, std::less<>> rfc_variables = {
+    {"count", urlmodel::uri_template::list_type(count)},
+    {"dom", urlmodel::uri_template::list_type(dom)},
+    {"dub", std::string_view("me/too")},
+    {"hello", std::string_view("Hello World!")},
+    {"half", std::string_view("50%")},
+    {"var", std::string_view("value")},
+    {"who", std::string_view("fred")},
+    {"base", std::string_view("http://example.com/home/")},
+    {"path", std::string_view("/foo/bar")},
+    {"list", urlmodel::uri_template::list_type(list)},
+    {"keys", urlmodel::uri_template::associative_array_type(keys)},
+    {"v", std::string_view("6")},
+    {"x", std::string_view("1024")},
+    {"y", std::string_view("768")},
+    {"empty", std::string_view("")},
+    {"empty_keys", urlmodel::uri_template::associative_array_type()},
+    {"undef", std::monostate()}
+};
+
+std::vector<value> get_values(const urlmodel::uri_template& t, const std::map<std::string, value, std::less<>>& variables){
+    std::vector<value> ret;
+    for(const auto& name : t.get_variables()){
+        auto i = variables.find(name);
+        ret.push_back(i == variables.end() ? value() : i->second);
+    }
+    return ret;
+}
+
+urlmodel::url parse(std::string_view str){
+    urlmodel::parser parser;
+    parser.feed(to_span(str));
+    parser.end_of_data();
+    return std::move(parser.url);
+}
+}
+
+namespace{
+const tst::set set("urlmodel__uri_template", [](tst::suite& suite){
+    // examples from RFC 6570 section 3.2
+    suite.add<std::pair<std::string_view, std::string_view>>(
+        "rfc_examples",
+        {
+            {"{var}", "value"},
+            {"{hello}", "Hello%20World%21"},
+            {"{half}", "50%25"},
+            {"O{empty}X", "OX"},
+            {"O{undef}X", "OX"},
+            {"{x,y}", "1024,768"},
+            {"{x,hello,y}", "1024,Hello%20World%21,768"},
+            {"?{x,empty}", "?1024,"},
+            {"?{x,undef}", "?1024"},
+            {"?{undef,y}", "?768"},
+            {"{var:3}", "val"},
+            {"{var:30}", "value"},
+            {"{list}", "red,green,blue"},
+            {"{list*}", "red,green,blue"},
+            {"{keys}", "semi,%3B,dot,.,comma,%2C"},
+            {"{keys*}", "semi=%3B,dot=.,comma=%2C"},
+
+            {"{+var}", "value"},
+            {"{+hello}", "Hello%20World!"},
+            {"{+half}", "50%25"},
+            {"{base}index", "http%3A%2F%2Fexample.com%2Fhome%2Findex"},
+            {"{+base}index", "http://example.com/home/index"},
+            {"O{+empty}X", "OX"},
+            {"O{+undef}X", "OX"},
+            {"{+path}/here", "/foo/bar/here"},
+            {"here?ref={+path}", "here?ref=/foo/bar"},
+            {"up{+path}{var}/here", "up/foo/barvalue/here"},
+            {"{+x,hello,y}", "1024,Hello%20World!,768"},
+            {"{+path,x}/here", "/foo/bar,1024/here"},
+            {"{+path:6}/here", "/foo/b/here"},
+            {"{+list}", "red,green,blue"},
+            {"{+list*}", "red,green,blue"},
+            {"{+keys}", "semi,;,dot,.,comma,,"},
+            {"{+keys*}", "semi=;,dot=.,comma=,"},
+
+            {"{#var}", "#value"},
+            {"{#hello}", "#Hello%20World!"},
+            {"{#half}", "#50%25"},
+            {"foo{#empty}", "foo#"},
+            {"foo{#undef}", "foo"},
+            {"{#x,hello,y}", "#1024,Hello%20World!,768"},
+            {"{#path,x}/here", "#/foo/bar,1024/here"},
+            {"{#path:6}/here", "#/foo/b/here"},
+            {"{#list}", "#red,green,blue"},
+            {"{#list*}", "#red,green,blue"},
+            {"{#keys}", "#semi,;,dot,.,comma,,"},
+            {"{#keys*}", "#semi=;,dot=.,comma=,"},
+
+            {"{.who}", ".fred"},
+            {"{.who,who}", ".fred.fred"},
+            {"{.half,who}", ".50%25.fred"},
+            {"www{.dom*}", "www.example.com"},
+            {"X{.var}", "X.value"},
+            {"X{.empty}", "X."},
+            {"X{.undef}", "X"},
+            {"X{.var:3}", "X.val"},
+            {"X{.list}", "X.red,green,blue"},
+            {"X{.list*}", "X.red.green.blue"},
+            {"X{.keys}", "X.semi,%3B,dot,.,comma,%2C"},
+            {"X{.keys*}", "X.semi=%3B.dot=..comma=%2C"},
+            {"X{.empty_keys}", "X"},
+            {"X{.empty_keys*}", "X"},
+
+            {"{/who}", "/fred"},
+            {"{/who,who}", "/fred/fred"},
+            {"{/half,who}", "/50%25/fred"},
+            {"{/who,dub}", "/fred/me%2Ftoo"},
+            {"{/var}", "/value"},
+            {"{/var,empty}", "/value/"},
+            {"{/var,undef}", "/value"},
+            {"{/var,x}/here", "/value/1024/here"},
+            {"{/var:1,var}", "/v/value"},
+            {"{/list}", "/red,green,blue"},
+            {"{/list*}", "/red/green/blue"},
+            {"{/list*,path:4}", "/red/green/blue/%2Ffoo"},
+            {"{/keys}", "/semi,%3B,dot,.,comma,%2C"},
+            {"{/keys*}", "/semi=%3B/dot=./comma=%2C"},
+
+            {"{;who}", ";who=fred"},
+            {"{;half}", ";half=50%25"},
+            {"{;empty}", ";empty"},
+            {"{;v,empty,who}", ";v=6;empty;who=fred"},
+            {"{;v,bar,who}", ";v=6;who=fred"},
+            {"{;x,y}", ";x=1024;y=768"},
+            {"{;x,y,empty}", ";x=1024;y=768;empty"},
+            {"{;x,y,undef}", ";x=1024;y=768"},
+            {"{;hello:5}", ";hello=Hello"},
+            {"{;list}", ";list=red,green,blue"},
+            {"{;list*}", ";list=red;list=green;list=blue"},
+            {"{;keys}", ";keys=semi,%3B,dot,.,comma,%2C"},
+            {"{;keys*}", ";semi=%3B;dot=.;comma=%2C"},
+
+            {"{?who}", "?who=fred"},
+            {"{?half}", "?half=50%25"},
+            {"{?x,y}", "?x=1024&y=768"},
+            {"{?x,y,empty}", "?x=1024&y=768&empty="},
+            {"{?x,y,undef}", "?x=1024&y=768"},
+            {"{?var:3}", "?var=val"},
+            {"{?list}", "?list=red,green,blue"},
+            {"{?list*}", "?list=red&list=green&list=blue"},
+            {"{?keys}", "?keys=semi,%3B,dot,.,comma,%2C"},
+            {"{?keys*}", "?semi=%3B&dot=.&comma=%2C"},
+
+            {"{&who}", "&who=fred"},
+            {"{&half}", "&half=50%25"},
+            {"?fixed=yes{&x}", "?fixed=yes&x=1024"},
+            {"{&x,y,empty}", "&x=1024&y=768&empty="},
+            {"{&var:3}", "&var=val"},
+            {"{&list}", "&list=red,green,blue"},
+            {"{&list*}", "&list=red&list=green&list=blue"},
+            {"{&keys}", "&keys=semi,%3B,dot,.,comma,%2C"},
+            {"{&keys*}", "&semi=%3B&dot=.&comma=%2C"},
+
+            // literals
+            {"http://example.com/a%20b/c\"d", "http://example.com/a%20b/c%22d"},
+            // prefix counts characters, not bytes
+            {"{var:2}", "value"}
+        },
+        [](const auto& p){
+            urlmodel::uri_template t(p.first);
+
+            auto vars = rfc_variables;
+            if(p.first == "{var:2}"){
+                // cyrillic "pr" and "ivet"
+                vars["var"] = std::string_view("\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82");
+            }
+
+            auto res = t.expand(get_values(t, vars));
+
+            if(p.first == "{var:2}"){
+                tst::check_eq(res, std::string("%D0%BF%D1%80"), SL);
+            }else{
+                tst::check_eq(res, std::string(p.second), SL);
+            }
+        }
+    );
+
+    suite.add<std::string_view>(
+        "expand_url",
+        {
+            "https://{host}/v1/users/{id}{?fields,limit}",
+            "http://{user}@{host}:{port}{/path*}{?q}{#frag}",
+            "http://{host}{/segments*}{?params*}",
+            "{+base}users/{id}{;v}",
+            "/search{?q,lang}&extra=1",
+            "/search{?q}{&undef}",
+            "/files{/path*}/{name}.{ext}",
+            "http://example.com{+path}{?q}",
+            "{scheme}://{host}/{+path}",
+            "/{dub}/{half}/{hello}{#hello}"
+        },
+        [](const auto& p){
+            urlmodel::uri_template t(p);
+
+            const std::string_view fields[] = {"name", "email"};
+            const std::string_view segments[] = {"a b", "c/d", "", "e"};
+            const std::pair<std::string_view, std::string_view> params[] = {{"k1", "v&1"}, {"k2", ""}, {"k 3", "v3"}};
+
+            auto vars = rfc_variables;
+            vars.insert_or_assign("host", std::string_view("example.com"));
+            vars.insert_or_assign("id", std::string_view("42"));
+            vars.insert_or_assign("fields", urlmodel::uri_template::list_type(fields));
+            vars.insert_or_assign("limit", std::string_view("10"));
+            vars.insert_or_assign("user", std::string_view("john"));
+            vars.insert_or_assign("port", std::string_view("8080"));
+            vars.insert_or_assign("q", std::string_view("a&b=c #d"));
+            vars.insert_or_assign("frag", std::string_view("top"));
+            vars.insert_or_assign("segments", urlmodel::uri_template::list_type(segments));
+            vars.insert_or_assign("params", urlmodel::uri_template::associative_array_type(params));
+            vars.insert_or_assign("lang", std::string_view("en"));
+            vars.insert_or_assign("name", std::string_view("file name"));
+            vars.insert_or_assign("ext", std::string_view("txt"));
+            vars.insert_or_assign("scheme", std::string_view("https"));
+
+            auto values = get_values(t, vars);
+
+            auto str = t.expand(values);
+            auto expected = parse(str);
+
+            auto res = t.expand_url(values);
+
+            tst::check(res == expected, SL)
+                << "expanded = " << str << "\n"
+                << "url = " << res.to_string() << "\n"
+                << "expected = " << expected.to_string();
+        }
+    );
+
+    suite.add("variables", [](){
+        urlmodel::uri_template t("https://{host}/v1/users/{id}{?fields,limit}{&id}");
+
+        tst::check_eq(t.get_variables().size(), size_t(4), SL);
+        tst::check_eq(t.get_variable_index("host"), size_t(0), SL);
+        tst::check_eq(t.get_variable_index("id"), size_t(1), SL);
+        tst::check_eq(t.get_variable_index("fields"), size_t(2), SL);
+        tst::check_eq(t.get_variable_index("limit"), size_t(3), SL);
+
+        // missing values are undefined
+        const value values[] = {std::string_view("example.com"), std::string_view("42")};
+        tst::check_eq(t.expand(values), std::string("https://example.com/v1/users/42&id=42"), SL);
+
+        // appends to the buffer
+        std::string buf = "url: ";
+        t.expand(values, buf);
+        tst::check_eq(buf, std::string("url: https://example.com/v1/users/42&id=42"), SL);
+
+        tst::check(t.expand_url(values) == urlmodel::url{
+            .scheme = "https",
+            .host = "example.com",
+            .path = {"v1", "users", "42&id=42"}
+        }, SL);
+
+        bool thrown = false;
+        try{
+            t.get_variable_index("unknown");
+        }catch(std::invalid_argument&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+    });
+
+    suite.add<std::string_view>(
+        "malformed",
+        {
+            "{",
+            "/a/{b",
+            "}",
+            "/a}b",
+            "{}",
+            "{=x}",
+            "{!x}",
+            "{x,}",
+            "{,x}",
+            "{x:0}",
+            "{x:10000}",
+            "{x:}",
+            "{x:3*}",
+            "{.x.}",
+            "{x..y}",
+            "{x y}",
+            "{x-y}",
+            "a b",
+            "{%2x}"
+        },
+        [](const auto& p){
+            bool thrown = false;
+            try{
+                urlmodel::uri_template t(p);
+            }catch(std::invalid_argument&){
+                thrown = true;
+            }
+            tst::check(thrown, SL) << "template = " << p;
+        }
+    );
+});
+}
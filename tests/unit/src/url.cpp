@@ -82,5 +82,61 @@ const tst::set set("urlmodel__url", [](tst::suite& suite){
                 << "b = " << utki::make_span(p.second) << "\n";
         }
     );
+
+    suite.add<urlmodel::url>(
+        "to_pieces",
+        {
+            urlmodel::url{},
+            urlmodel::url{
+                .scheme = "http"
+            },
+            urlmodel::url{
+                .scheme = "http",
+                .host = "host.com"
+            },
+            urlmodel::url{
+                .scheme = "http",
+                .username = "user",
+                .host = "host.com",
+                .port = 1
+            },
+            urlmodel::url{
+                .scheme = "http",
+                .username = "user",
+                .password = "password",
+                .host = "host.com",
+                .port = 65535,
+                .path = {"path", "to", "dir"},
+                .query = {
+                    {"param1", "value1"},
+                    {"param2", ""}
+                },
+                .fragment = "fragment"
+            },
+            urlmodel::url{
+                .path = {"path", "to", "dir"},
+                .query = {
+                    {"param1", "value1"}
+                }
+            },
+            urlmodel::url{
+                .fragment = "fragment"
+            }
+        },
+        [](const auto& p){
+            std::vector<utki::span<const char>> pieces;
+            urlmodel::url::port_buffer port_buf;
+
+            p.to_pieces(pieces, port_buf);
+
+            std::string str;
+            for(const auto& piece : pieces){
+                tst::check(!piece.empty(), SL);
+                str.append(piece.data(), piece.size());
+            }
+
+            tst::check_eq(str, p.to_string(), SL);
+        }
+    );
 });
 }
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include <utki/span.hpp>
+
+inline utki::span<const uint8_t> to_span(std::string_view str){
+    return utki::make_span(
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        reinterpret_cast<const uint8_t*>(str.data()),
+        str.size()
+    );
+}